@@ -0,0 +1,10 @@
+#!/bin/bash
+
+# Compile the source code with the benchmarks enabled instead of the game
+g++ -O2 -DMAZE_BENCHMARK -c Projects/MazeGame.cpp -o Benchmark.o
+
+# Link the object file with the SFML libraries to create the executable
+g++ Benchmark.o -o MazeBenchmark -lsfml-graphics -lsfml-window -lsfml-system -pthread
+
+# Run the benchmarks
+./MazeBenchmark
@@ -1,3 +1,3 @@
 g++ -I src/include -c Projects/MazeGame.cpp -o Main.o
-g++ Main.o -o PacMan -L src/lib -lsfml-graphics -lsfml-window -lsfml-system 
+g++ Main.o -o PacMan -L src/lib -lsfml-graphics -lsfml-window -lsfml-system -pthread
 PacMan.exe
\ No newline at end of file
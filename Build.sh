@@ -4,7 +4,7 @@
 g++ -c Projects/MazeGame.cpp -o Main.o
 
 # Link the object file with the SFML libraries to create the executable
-g++ Main.o -o MazeGame -lsfml-graphics -lsfml-window -lsfml-system
+g++ Main.o -o MazeGame -lsfml-graphics -lsfml-window -lsfml-system -pthread
 
 # Run the executable
 ./MazeGame
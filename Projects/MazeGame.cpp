@@ -1,8 +1,18 @@
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <random>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace sf;
@@ -10,9 +20,18 @@ using namespace std;
 
 ////////////////GENERAL SETTINGS AND FUNCTIONS///////////////////////////////////
 
-#define CELLCOUNT 16                           // defines the size of the grid CELLCOUNT by CELLCOUNT
-#define WINDOWDIMENSIONS 800                   // defines the dimensions of the window WINDOWDIMENSIONS by WINDOWDIMENSIONS
-#define CELLSIZE WINDOWDIMENSIONS / CELLCOUNT  // defines how to calculate the cell size
+#ifndef CELLCOUNT
+#define CELLCOUNT 16                             // defines the size of the grid CELLCOUNT by CELLCOUNT, can be set when building for larger mazes
+#endif
+#define WINDOWDIMENSIONS 800                     // defines the dimensions of the window WINDOWDIMENSIONS by WINDOWDIMENSIONS
+#ifndef CELLSIZE
+#define CELLSIZE (WINDOWDIMENSIONS / CELLCOUNT)  // defines how to calculate the cell size, set it as well with a large CELLCOUNT to keep cells readable
+#endif
+#define MINZOOM 0.25f                            // defines how far the camera can zoom in, as a fraction of the window
+#define IDLESLEEP 2                              // defines how many milliseconds the game screen waits on a frame where nothing changed
+#define ENEMYCOUNT 4                             // defines how many enemies are spawned in the maze
+#define HUNTERCOUNT 1                            // defines how many of those enemies hunt the player down instead of wandering
+#define SPAWNDISTANCE 8                          // defines the fewest steps between the player and a newly spawned enemy
 
 /**
  * @brief struct containing 4 boolean vairables that specify whether there are neighbours present in a particular direction and 4 integer variables that hold the index of these neigbours.
@@ -66,360 +85,166 @@ int returnArrayIndex(int x, int y) { return (x) + (CELLCOUNT * (y)); }
  */
 Vector2i returnCoordinates(int CellID) { return Vector2i(CellID % CELLCOUNT, CellID / CELLCOUNT); }
 
-////////////////GENERAL SETTINGS AND FUNCTIONS///////////////////////////////////
-
-////////////////ENTITY SETTINGS AND FUNCTIONS///////////////////////////////////
-
 /**
- * @brief Base call for entities like players and enemies.
+ * @brief Returns the position of the center of a cell's body without going through the cell itself
  *
+ * @param CellID
+ * @return Vector2f
  */
-class Entity {
-   private:
-    // holds the cell index for the entity
-    int _cellIndex;
-    // renderable body of the entity
-    CircleShape _body;
-
-   public:
-    /**
-     * @brief Construct a new Entity object
-     *
-     */
-    Entity(int x, int y, int cellIndex, Color color, int pointCount) {
-        _body.setRadius(CELLSIZE / 4);
-        _body.setPosition(Vector2f(x, y));
-        _body.setOrigin(Vector2f(_body.getLocalBounds().width / 2, _body.getLocalBounds().height / 2));
-        _body.setFillColor(color);
-        _body.setPointCount(pointCount);
-        SetCellID(cellIndex);
-    }
-
-    Entity() : Entity(0, 0, 0, Color::Yellow, 6) {
-    }
-
-    /**
-     * @brief Returns the body of the Entity
-     *
-     * @return CircleShape
-     */
-    CircleShape Body() { return _body; }
-
-    /**
-     * @brief Checks for collision between two entities.
-     *
-     * @param Body
-     * @return true
-     * @return false
-     */
-    bool IsAt(FloatRect Body) { return _body.getGlobalBounds().intersects(Body); }
-
-    /**
-     * @brief Abstract method that is required in the child classes
-     *
-     * @return CircleShape
-     */
-    virtual CircleShape ReturnEntity() = 0;
-
-    /**
-     * @brief Set the Cell ID or index of the entity
-     *
-     * @param ID
-     */
-    void SetCellID(int ID) { _cellIndex = ID; }
-
-    /**
-     * @brief Get the Cell ID or index of the entity
-     *
-     * @return int
-     */
-    int GetCellID() { return _cellIndex; }
-
-    /**
-     * @brief Updates the position of the entity
-     *
-     * @param position
-     */
-    void SetPosition(Vector2f position) {
-        _body.setPosition(position);
-    }
-
-    /**
-     * @brief Updates the color of the entity
-     *
-     * @param color
-     */
-    void SetFillColor(Color color) {
-        _body.setFillColor(color);
-    }
-
-    /**
-     * @brief Updates the point count of the entity
-     *
-     * @param pointCount
-     */
-    void SetPointCount(int pointCount) {
-        _body.setPointCount(pointCount);
-    }
-};
+Vector2f returnCellCenter(int CellID) {
+    Vector2i Coordinates = returnCoordinates(CellID);
+    return Vector2f(Coordinates.x * CELLSIZE + (CELLSIZE - 3) / 2.f, Coordinates.y * CELLSIZE + (CELLSIZE - 3) / 2.f);
+}
 
 /**
- * @brief Child of Entity class and builds upon it to allow for the game to have players
+ * @brief Returns the range of cells of a width by height maze that a view can see, widened by a cell on every side so walls drawn just
+ * outside their cell are kept. The range is empty when the view is off the maze
  *
+ * @param view
+ * @param width
+ * @param height
+ * @return IntRect
  */
-class Player : public Entity {
-   private:
-   public:
-    /**
-     * @brief Construct a new Player object
-     *
-     */
-    Player() : Entity(0, 0, 0, Color::Yellow, 10) {
-    }
-
-    /**
-     * @brief Construct a new Player object
-     *
-     * @param x
-     * @param y
-     * @param cellIndex
-     * @param Color
-     */
-    Player(int x, int y, int cellIndex, Color color) : Entity(x, y, cellIndex, color, 10) {
-    }
-
-    /**
-     * @brief Updates the position of the player entity
-     *
-     * @param position
-     */
-    void UpdatePosition(Vector2f position) {
-        SetPosition(position);
-    }
-
-    /**
-     * @brief Moves the player to the cell index north of its current index
-     *
-     * @param neighbours
-     * @return int
-     */
-    int MoveUp(Int4 neighbours) {
-        if (neighbours.Top_present) {
-            SetCellID(neighbours.Top);
-        }
-        return GetCellID();
-    }
-
-    /**
-     * @brief Moves the player to the cell index south of its current index
-     *
-     * @param neighbours
-     * @return int
-     */
-    int MoveDown(Int4 neighbours) {
-        if (neighbours.Bottom_present) {
-            SetCellID(neighbours.Bottom);
-        }
-        return GetCellID();
-    }
+IntRect returnVisibleCells(const View &view, int width, int height) {
+    Vector2f corner = view.getCenter() - view.getSize() / 2.f;
+    int left = max(0, (int)floor(corner.x / CELLSIZE) - 1);
+    int top = max(0, (int)floor(corner.y / CELLSIZE) - 1);
+    int right = min(width, (int)ceil((corner.x + view.getSize().x) / CELLSIZE) + 1);
+    int bottom = min(height, (int)ceil((corner.y + view.getSize().y) / CELLSIZE) + 1);
+    return IntRect(left, top, max(0, right - left), max(0, bottom - top));
+}
 
-    /**
-     * @brief Moves the player to the cell index west of its current index
-     *
-     * @param neighbours
-     * @return int
-     */
-    int MoveLeft(Int4 neighbours) {
-        if (neighbours.Left_present) {
-            SetCellID(neighbours.Left);
-        }
-        return GetCellID();
-    }
+/**
+ * @brief Returns where a camera of the given size should be centered to follow a point without showing past the edges of the maze. Along an
+ * axis where the maze is smaller than the camera the maze is centered instead
+ *
+ * @param focus
+ * @param viewSize
+ * @param mazeSize
+ * @return Vector2f
+ */
+Vector2f returnCameraCenter(Vector2f focus, Vector2f viewSize, Vector2f mazeSize) {
+    Vector2f center;
+    center.x = (viewSize.x >= mazeSize.x) ? mazeSize.x / 2 : min(max(focus.x, viewSize.x / 2), mazeSize.x - viewSize.x / 2);
+    center.y = (viewSize.y >= mazeSize.y) ? mazeSize.y / 2 : min(max(focus.y, viewSize.y / 2), mazeSize.y - viewSize.y / 2);
+    return center;
+}
 
-    /**
-     * @brief Moves the player to the cell index east of its current index
-     *
-     * @param neighbours
-     * @return int
-     */
-    int MoveRight(Int4 neighbours) {
-        if (neighbours.Right_present) {
-            SetCellID(neighbours.Right);
-        }
-        return GetCellID();
-    }
+////////////////GENERAL SETTINGS AND FUNCTIONS///////////////////////////////////
 
-    /**
-     * @brief Returns the renderable body of the player
-     *
-     * @return CircleShape
-     */
-    CircleShape ReturnEntity() override { return Body(); }
-};
+////////////////THREADING SETTINGS AND FUNCTIONS///////////////////////////////////
 
 /**
- * @brief Child of Entity class and builds upon it to allow for the game to have enemies
+ * @brief Fixed team of worker threads that run the same job together, the calling thread takes part as worker 0. Threads are started once
+ * so jobs that are run many times in a row, like the levels of a search, don't pay for creating threads each time
  *
  */
-class Enemy : public Entity {
+class WorkerPool {
    private:
-    int _timer;         // Waits 3 cycles before next move | Empathy for player
-    bool _entityState;  // True - Attack | False - Passive
+    vector<thread> _workers;          // Threads started by the pool, worker i + 1 runs on _workers[i]
+    mutex _mutex;                     // Guards the job, generation and pending count
+    condition_variable _wake;         // Signalled when a new job is ready or the pool is stopping
+    condition_variable _done;         // Signalled when the last worker finishes a job
+    const function<void(int)> *_job;  // Job of the current generation
+    int _generation;                  // Counts the jobs handed out so workers can tell a new one from the last
+    int _pending;                     // Workers still running the current job
+    bool _stopping;                   // Set when the pool is destroyed
 
     /**
-     * @brief Switches the state of the enemy from attack to passive or vice versa
-     *
-     */
-    void switchState() { _entityState = !_entityState; }
-
-    /**
-     * @brief Checks the state of the current or potential cell index to see if it's the start or end and returns true only if it's a path
-     *
-     * @param State
-     * @return true
-     * @return false
-     */
-    bool CanEnemyBeHere(int State) { return (State == 0) ? true : false; }
-
-    /**
-     * @brief Checks if the player is in this particular cell and makes sure it's not the starting cell or the ending cell
+     * @brief Loop run by every worker thread, waits for a job, runs it and reports back
      *
      * @param index
-     * @param playerIndex
-     * @param State
-     * @return true
-     * @return false
      */
-    bool IsPlayerThere(int index, int playerIndex) {
-        return (playerIndex == index && !((playerIndex == 0) || (playerIndex == ((CELLCOUNT * CELLCOUNT) - 1)))) ? true : false;
+    void workerLoop(int index) {
+        int seenGeneration = 0;
+        while (true) {
+            const function<void(int)> *job;
+            {
+                unique_lock<mutex> lock(_mutex);
+                _wake.wait(lock, [&] { return _stopping || _generation != seenGeneration; });
+                if (_stopping) {
+                    return;
+                }
+                seenGeneration = _generation;
+                job = _job;
+            }
+            (*job)(index);
+            {
+                lock_guard<mutex> lock(_mutex);
+                if (--_pending == 0) {
+                    _done.notify_one();
+                }
+            }
+        }
     }
 
    public:
     /**
-     * @brief Construct a new Enemy object
-     *
-     */
-    Enemy() : Enemy(0, 0, 6, 0, Color::Red, true) {
-    }
-
-    /**
-     * @brief Construct a new Enemy object
-     * 
-     * @param x 
-     * @param y 
-     * @param pointCount 
-     * @param cellIndex 
-     * @param color 
-     * @param enemyState 
-     */
-    Enemy(int x, int y, int pointCount, int cellIndex, Color color, bool enemyState) : Entity(x, y, cellIndex, color, pointCount) {
-        _entityState = enemyState;
-    }
-
-    /**
-     * @brief Resets the enemy with new values
+     * @brief Construct a new WorkerPool object, a thread count of 0 uses every hardware thread
      *
-     * @param x
-     * @param y
-     * @param pointCount
-     * @param cellIndex
-     * @param color
+     * @param threadCount
      */
-    void EnemySetup(int x, int y, int pointCount, int cellIndex, Color color, bool EnemyState) {
-        SetPosition(Vector2f(x, y));
-        SetFillColor(color);
-        SetPointCount(pointCount);
-        _entityState = EnemyState;
+    WorkerPool(int threadCount = 0) {
+        _job = NULL;
+        _generation = 0;
+        _pending = 0;
+        _stopping = false;
+        if (threadCount <= 0) {
+            threadCount = max(1, (int)thread::hardware_concurrency());
+        }
+        for (int i = 1; i < threadCount; i++) {
+            _workers.push_back(thread(&WorkerPool::workerLoop, this, i));
+        }
     }
 
     /**
-     * @brief Get the Entity State of the object
-     *
-     * @return true
-     * @return false
-     */
-    bool GetEntityState() { return _entityState; }
-
-    /**
-     * @brief Sets the position to a new value
+     * @brief Destroy the WorkerPool object and join its threads
      *
-     * @param position
      */
-    void UpdatePosition(Vector2f position) {
-        SetPosition(position);
+    ~WorkerPool() {
+        {
+            lock_guard<mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _wake.notify_all();
+        for (size_t i = 0; i < _workers.size(); i++) {
+            _workers[i].join();
+        }
     }
 
     /**
-     * @brief Switches the enemy state and updates the color of the body to reflect this change Red - Attack | Green - Passive
+     * @brief Returns the number of threads that run each job, including the caller
      *
+     * @return int
      */
-    void SwitchEntityState() {
-        if (_entityState) {
-            SetFillColor(Color::Red);
-        } else {
-            SetFillColor(Color::Green);
-        }
-        switchState();
+    int ThreadCount() {
+        return _workers.size() + 1;
     }
 
     /**
-     * @brief Moves the enemy to a random neighbour cell by creating a list of potential positions and then shuffling it after which fainally selecting a random one
+     * @brief Runs job(i) once for every worker index and returns when all of them have finished
      *
-     * @param neighbours
-     * @param playerIndex
-     * @param neighbourCellStates
-     * @return int
+     * @param job
      */
-    int MoveEnemy(Int4 neighbours, int playerIndex, Bool4 neighbourCellStates) {
-        int i = 0;
-        int List[4];
-        if (neighbours.Top_present) {
-            if (IsPlayerThere(neighbours.Top, playerIndex)) {
-                return neighbours.Top;
-            } else {
-                List[i] = neighbours.Top;
-                i++;
-            }
-        }
-        if (neighbours.Right_present) {
-            if (IsPlayerThere(neighbours.Right, playerIndex)) {
-                return neighbours.Right;
-            } else {
-                List[i] = neighbours.Right;
-                i++;
-            }
-        }
-        if (neighbours.Bottom_present) {
-            if (IsPlayerThere(neighbours.Bottom, playerIndex)) {
-                return neighbours.Bottom;
-            } else {
-                List[i] = neighbours.Bottom;
-                i++;
-            }
+    void Run(const function<void(int)> &job) {
+        if (_workers.empty()) {
+            job(0);
+            return;
         }
-        if (neighbours.Left_present) {
-            if (IsPlayerThere(neighbours.Left, playerIndex)) {
-                return neighbours.Left;
-            } else {
-                List[i] = neighbours.Left;
-                i++;
-            }
+        {
+            lock_guard<mutex> lock(_mutex);
+            _job = &job;
+            _pending = _workers.size();
+            _generation++;
         }
-
-        random_shuffle(&List[0], &List[i]);
-        SetCellID(List[0]);
-        return List[0];
+        _wake.notify_all();
+        job(0);
+        unique_lock<mutex> lock(_mutex);
+        _done.wait(lock, [&] { return _pending == 0; });
     }
-
-    /**
-     * @brief Returns the entity body
-     * 
-     * @return CircleShape 
-     */
-    CircleShape ReturnEntity() override { return Body(); }
 };
 
-////////////////ENTITY SETTINGS AND FUNCTIONS///////////////////////////////////
+////////////////THREADING SETTINGS AND FUNCTIONS///////////////////////////////////
 
 ////////////////GRID SETTINGS AND FUNCTIONS///////////////////////////////////
 
@@ -525,7 +350,7 @@ class Wall {
  * @brief Class for a single cell object
  *
  */
-class Cell {
+class Cell : public Drawable {
    private:
     Wall _cellWalls;       // Walls of the cells
     RectangleShape _cell;  // Renderable body of the cell
@@ -617,6 +442,19 @@ class Cell {
         }
     }
 
+    /**
+     * @brief Draws the body of the cell and its four walls in place
+     *
+     * @param target
+     * @param states
+     */
+    void draw(RenderTarget &target, RenderStates states) const override {
+        target.draw(_cell, states);
+        for (int i = 0; i < 4; i++) {
+            target.draw(_cellWalls.Walls[i], states);
+        }
+    }
+
    public:
     bool visited;  // vairable that holds whether this cell has been visited or not, used during the maze generation process
 
@@ -734,6 +572,29 @@ class Cell {
         UpdateWalls();
     }
 
+    /**
+     * @brief Puts back a specific wall and updates the cells walls
+     *
+     * @param ID
+     */
+    void AddWall(int ID) {
+        switch (ID) {
+            case 0:
+                _cellWalls.wall_configuration.TOP = true;
+                break;
+            case 1:
+                _cellWalls.wall_configuration.RIGHT = true;
+                break;
+            case 2:
+                _cellWalls.wall_configuration.BOTTOM = true;
+                break;
+            case 3:
+                _cellWalls.wall_configuration.LEFT = true;
+                break;
+        }
+        UpdateWalls();
+    }
+
     /**
      * @brief Resets the cells values to reflect the new values as set in the parameters
      *
@@ -754,9 +615,9 @@ class Cell {
     /**
      * @brief Gets the renderable component of the cell
      *
-     * @return RectangleShape
+     * @return const RectangleShape&
      */
-    RectangleShape CELL() {
+    const RectangleShape &CELL() const {
         return _cell;
     }
 
@@ -764,227 +625,3840 @@ class Cell {
      * @brief Returns a part of renderable component a wall of the cell
      *
      * @param index
-     * @return RectangleShape
+     * @return const RectangleShape&
      */
-    RectangleShape WALL(int index) {
+    const RectangleShape &WALL(int index) const {
         return _cellWalls.Walls[index];
     }
 };
 
 /**
- * @brief Grid object that holds the grid of cells
+ * @brief Compact wall storage for a maze of any size. Every cell owns two passage bits, one to the cell on its right and one to the cell below,
+ * packed into 64 bit words with every row padded to a whole number of words. Directions follow the wall indices 0 - Top | 1 - Right | 2 - Bottom | 3 - Left
  *
  */
-class Grid {
+class PackedMaze {
    private:
-    Stack _visitedCells;  // Stack of visited cells used during the maze generation to go back to last visited cell
+    int _width;               // Number of cells in a row
+    int _height;              // Number of rows
+    int _wordsPerRow;         // Number of 64 bit words holding a row of passage bits
+    vector<uint64_t> _east;   // Bit is set when the passage to the cell on the right is open
+    vector<uint64_t> _south;  // Bit is set when the passage to the cell below is open
+    uint32_t _revision;       // Goes up every time a wall is opened or closed so cached geometry can tell the maze changed
 
     /**
-     * @brief Returns the configuration of the neighbours present for a particular cell
+     * @brief Reads the passage bit of a cell from one of the bitsets
      *
-     * @param Array
-     * @param CELL_ID
-     * @return Int4
+     * @param bits
+     * @param x
+     * @param y
+     * @return true
+     * @return false
      */
-    Int4 noOfNeighbour(Cell Array[], int CELL_ID) {
-        Int4 neighbours;
-        Vector2i Coordinates = returnCoordinates(CELL_ID);
-        if (Coordinates.y - 1 >= 0 && !(Array[returnArrayIndex(Coordinates.x, Coordinates.y - 1)].visited)) {
-            neighbours.Top_present = true;
-            neighbours.Top = returnArrayIndex(Coordinates.x, Coordinates.y - 1);
-        }
-        if (Coordinates.y + 1 < CELLCOUNT && !(Array[returnArrayIndex(Coordinates.x, Coordinates.y + 1)].visited)) {
-            neighbours.Bottom_present = true;
-            neighbours.Bottom = returnArrayIndex(Coordinates.x, Coordinates.y + 1);
-        }
-        if (Coordinates.x - 1 >= 0 && !(Array[returnArrayIndex(Coordinates.x - 1, Coordinates.y)].visited)) {
-            neighbours.Left_present = true;
-            neighbours.Left = returnArrayIndex(Coordinates.x - 1, Coordinates.y);
-        }
-        if (Coordinates.x + 1 < CELLCOUNT && !(Array[returnArrayIndex(Coordinates.x + 1, Coordinates.y)].visited)) {
-            neighbours.Right_present = true;
-            neighbours.Right = returnArrayIndex(Coordinates.x + 1, Coordinates.y);
+    bool getBit(const vector<uint64_t> &bits, int x, int y) const {
+        return (bits[y * _wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+    }
+
+    /**
+     * @brief Writes the passage bit of a cell in one of the bitsets
+     *
+     * @param bits
+     * @param x
+     * @param y
+     * @param value
+     */
+    void setBit(vector<uint64_t> &bits, int x, int y, bool value) {
+        uint64_t mask = (uint64_t)1 << (x & 63);
+        if (value) {
+            bits[y * _wordsPerRow + (x >> 6)] |= mask;
+        } else {
+            bits[y * _wordsPerRow + (x >> 6)] &= ~mask;
         }
+    }
 
-        return neighbours;
+    /**
+     * @brief Opens or closes the wall between a cell and its neighbour, walls on the border of the maze are left untouched
+     *
+     * @param index
+     * @param direction
+     * @param open
+     */
+    void setPassage(int index, int direction, bool open) {
+        _revision++;
+        int x = index % _width;
+        int y = index / _width;
+        switch (direction) {
+            case 0:
+                if (y > 0) {
+                    setBit(_south, x, y - 1, open);
+                }
+                break;
+            case 1:
+                if (x + 1 < _width) {
+                    setBit(_east, x, y, open);
+                }
+                break;
+            case 2:
+                if (y + 1 < _height) {
+                    setBit(_south, x, y, open);
+                }
+                break;
+            case 3:
+                if (x > 0) {
+                    setBit(_east, x - 1, y, open);
+                }
+                break;
+        }
     }
 
+   public:
     /**
-     * @brief picks a random neighbour from a collection of neighbours and stores the neighbours cell index and path details and returns it
+     * @brief Construct a new PackedMaze object the same size as the game grid with every wall standing
      *
-     * @param NeighboursList
-     * @return Vector3i
      */
-    Vector3i randomNeighbour(Int4 NeighboursList) {
-        int i = 0;
-        Vector3i List[4];
-        Vector3i ReturnValue(CELLCOUNT * CELLCOUNT, 0, 0);  // CellID | From | To
-        if (NeighboursList.Bottom_present) {
-            List[i].x = NeighboursList.Bottom;
-            List[i].y = 2;
-            List[i].z = 0;
-            i++;
+    PackedMaze() : PackedMaze(CELLCOUNT, CELLCOUNT) {
+    }
+
+    /**
+     * @brief Construct a new PackedMaze object with every wall standing
+     *
+     * @param width
+     * @param height
+     */
+    PackedMaze(int width, int height) {
+        _width = width;
+        _height = height;
+        _wordsPerRow = (width + 63) / 64;
+        _revision = 0;
+        _east.assign((size_t)_wordsPerRow * height, 0);
+        _south.assign((size_t)_wordsPerRow * height, 0);
+    }
+
+    int Width() const { return _width; }
+
+    int Height() const { return _height; }
+
+    int CellCount() const { return _width * _height; }
+
+    int WordsPerRow() const { return _wordsPerRow; }
+
+    uint32_t Revision() const { return _revision; }
+
+    /**
+     * @brief Returns the words of east passage bits of a row, bit x of the row is the passage from cell x to cell x + 1
+     *
+     * @param y
+     * @return const uint64_t*
+     */
+    const uint64_t *EastRow(int y) const { return &_east[(size_t)y * _wordsPerRow]; }
+
+    /**
+     * @brief Returns the words of south passage bits of a row, bit x of the row is the passage from cell x down to the row below
+     *
+     * @param y
+     * @return const uint64_t*
+     */
+    const uint64_t *SouthRow(int y) const { return &_south[(size_t)y * _wordsPerRow]; }
+
+    /**
+     * @brief Checks whether the passage from a cell in the given direction is open
+     *
+     * @param index
+     * @param direction
+     * @return true
+     * @return false
+     */
+    bool IsOpen(int index, int direction) const {
+        return (OpenMask(index) >> direction) & 1;
+    }
+
+    /**
+     * @brief Returns a 4 bit mask of the open sides of a cell, bit 0 - Top | 1 - Right | 2 - Bottom | 3 - Left
+     *
+     * @param index
+     * @return int
+     */
+    int OpenMask(int index) const {
+        int x = index % _width;
+        int y = index / _width;
+        int mask = 0;
+        if (y > 0 && getBit(_south, x, y - 1)) {
+            mask |= 1;
         }
-        if (NeighboursList.Top_present) {
-            List[i].x = NeighboursList.Top;
-            List[i].y = 0;
-            List[i].z = 2;
-            i++;
+        if (getBit(_east, x, y)) {
+            mask |= 2;
         }
-        if (NeighboursList.Left_present) {
-            List[i].x = NeighboursList.Left;
-            List[i].y = 3;
-            List[i].z = 1;
-            i++;
+        if (getBit(_south, x, y)) {
+            mask |= 4;
         }
-        if (NeighboursList.Right_present) {
-            List[i].x = NeighboursList.Right;
-            List[i].y = 1;
-            List[i].z = 3;
-            i++;
+        if (x > 0 && getBit(_east, x - 1, y)) {
+            mask |= 8;
         }
-        if (i == 0) {
-            return ReturnValue;
+        return mask;
+    }
+
+    /**
+     * @brief Returns the index of the cell next to the given one in a direction, the caller makes sure that side is open
+     *
+     * @param index
+     * @param direction
+     * @return int
+     */
+    int Neighbour(int index, int direction) const {
+        switch (direction) {
+            case 0:
+                return index - _width;
+            case 1:
+                return index + 1;
+            case 2:
+                return index + _width;
+            default:
+                return index - 1;
         }
-        random_shuffle(&List[0], &List[i]);
-        ReturnValue = List[rand() % i];
-        return ReturnValue;
     }
 
     /**
-     * @brief runs a backtracking maze generation algorithm to create a maze in a 2D grid
+     * @brief Get the Neighbours from a cells index, same layout as the Grid so code written against either can be shared
      *
+     * @param Index
+     * @return Int4
      */
-    void GenerateMaze() {
-        srand(time(NULL));
-        int No_Visited_Cells = CELLCOUNT * CELLCOUNT;
-        int Previous_Cell_ID = returnArrayIndex(rand() % CELLCOUNT, rand() % CELLCOUNT);
+    Int4 GetNeighbours(int Index) const {
+        Int4 neighbours;
+        int open = OpenMask(Index);
+        if (open & 1) {
+            neighbours.Top_present = true;
+            neighbours.Top = Index - _width;
+        }
+        if (open & 2) {
+            neighbours.Right_present = true;
+            neighbours.Right = Index + 1;
+        }
+        if (open & 4) {
+            neighbours.Bottom_present = true;
+            neighbours.Bottom = Index + _width;
+        }
+        if (open & 8) {
+            neighbours.Left_present = true;
+            neighbours.Left = Index - 1;
+        }
+        return neighbours;
+    }
 
-        while (No_Visited_Cells != 0) {
-            Int4 Neighbours = noOfNeighbour(grid, Previous_Cell_ID);
-            Vector3i Cell_Number = randomNeighbour(Neighbours);
-            if (Cell_Number.x == CELLCOUNT * CELLCOUNT) {
-                grid[Previous_Cell_ID].visited = true;
-                Previous_Cell_ID = _visitedCells.Pop();
-                --No_Visited_Cells;
+    /**
+     * @brief Removes the wall on one side of a cell, the neighbouring cell shares the same bit so both sides open together
+     *
+     * @param index
+     * @param direction
+     */
+    void RemoveWall(int index, int direction) {
+        setPassage(index, direction, true);
+    }
+
+    /**
+     * @brief Puts back the wall on one side of a cell
+     *
+     * @param index
+     * @param direction
+     */
+    void AddWall(int index, int direction) {
+        setPassage(index, direction, false);
+    }
+
+    /**
+     * @brief Runs the same backtracking algorithm as the Grid directly on the packed walls so mazes far larger than the window can be generated,
+     * each cell remembers the direction it was entered from so no separate stack is needed
+     *
+     * @param seed
+     */
+    void GenerateMaze(unsigned int seed) {
+        mt19937 random(seed);
+        _revision++;
+        _east.assign(_east.size(), 0);
+        _south.assign(_south.size(), 0);
+
+        // 0 - Unvisited | 1 to 4 - Entered through the side (value - 1) | 5 - Starting cell
+        vector<uint8_t> cameFrom(CellCount(), 0);
+        int current = random() % CellCount();
+        cameFrom[current] = 5;
+
+        while (current != -1) {
+            int x = current % _width;
+            int y = current / _width;
+            int List[4];
+            int i = 0;
+            if (y > 0 && cameFrom[current - _width] == 0) {
+                List[i++] = 0;
+            }
+            if (x + 1 < _width && cameFrom[current + 1] == 0) {
+                List[i++] = 1;
+            }
+            if (y + 1 < _height && cameFrom[current + _width] == 0) {
+                List[i++] = 2;
+            }
+            if (x > 0 && cameFrom[current - 1] == 0) {
+                List[i++] = 3;
+            }
+
+            if (i == 0) {
+                current = (cameFrom[current] == 5) ? -1 : Neighbour(current, cameFrom[current] - 1);
             } else {
-                grid[Cell_Number.x].visited = true;
-                grid[Previous_Cell_ID].RemoveWall(Cell_Number.y);
-                grid[Cell_Number.x].RemoveWall(Cell_Number.z);
-                _visitedCells.Push(Cell_Number.x);
-                Previous_Cell_ID = Cell_Number.x;
+                int direction = List[random() % i];
+                int next = Neighbour(current, direction);
+                RemoveWall(current, direction);
+                cameFrom[next] = 1 + ((direction + 2) & 3);
+                current = next;
             }
         }
     }
 
-   public:
-    Cell grid[CELLCOUNT * CELLCOUNT];  // Main grid of the maze
+    /**
+     * @brief Removes a fraction of the remaining inner walls at random which turns a perfect maze into a braided one with loops
+     *
+     * @param loopDensity
+     * @param seed
+     */
+    void AddLoops(float loopDensity, unsigned int seed) {
+        mt19937 random(seed);
+        uniform_real_distribution<float> chance(0.0f, 1.0f);
+        for (int index = 0; index < CellCount(); index++) {
+            if (!IsOpen(index, 1) && chance(random) < loopDensity) {
+                RemoveWall(index, 1);
+            }
+            if (!IsOpen(index, 2) && chance(random) < loopDensity) {
+                RemoveWall(index, 2);
+            }
+        }
+    }
+};
+
+/**
+ * @brief Distance in steps from every cell to the nearest of one or more source cells, worked out once with a breadth first search and then read
+ * in O(1). When a wall is opened or closed, or a source moves, only the cells whose distance actually changes are visited again
+ *
+ */
+class DistanceField {
+   private:
+    vector<uint32_t> _distance;           // Steps from each cell to the nearest source, UNREACHABLE if there is no path
+    vector<uint32_t> _sourceCount;        // Number of sources sitting in each cell
+    vector<int> _queue;                   // Cells waiting to be processed during a search or an update
+    vector<int> _changed;                 // Cells that lost their distance while closing a wall or removing a source
+    vector<pair<uint32_t, int> > _seeds;  // Distances offered to the lost cells by their neighbours, sorted before filling them back in
 
     /**
-     * @brief Construct a new Grid object
+     * @brief Runs a breadth first search from the cells already in the queue, only cells that improve are visited
      *
+     * @param maze
      */
-    Grid() {
-        int xPos = 0;
-        int yPos = 0;
-        for (int x = 0; x < CELLCOUNT; x++) {
-            for (int y = 0; y < CELLCOUNT; y++) {
-                int cellID = x * CELLCOUNT + y;
-                grid[cellID] = Cell(xPos, yPos, CELLCOUNT, CELLCOUNT, Color::Black);
-                xPos += CELLSIZE;
+    void relax(const PackedMaze &maze) {
+        for (size_t head = 0; head < _queue.size(); head++) {
+            int current = _queue[head];
+            if (_distance[current] == UNREACHABLE) {
+                continue;
+            }
+            int open = maze.OpenMask(current);
+            for (int direction = 0; direction < 4; direction++) {
+                if (!((open >> direction) & 1)) {
+                    continue;
+                }
+                int next = maze.Neighbour(current, direction);
+                if (_distance[current] + 1 < _distance[next]) {
+                    _distance[next] = _distance[current] + 1;
+                    _queue.push_back(next);
+                }
             }
-            yPos += CELLSIZE;
-            xPos = 0;
         }
-        GenerateMaze();
-        // Setting the first and last cell to be the start and end points
-        grid[0].SetState(1);
-        grid[(CELLCOUNT * CELLCOUNT) - 1].SetState(2);
+        _queue.clear();
     }
 
     /**
-     * @brief Get the Neighbours from a cells index
+     * @brief Removes the distance of every cell that depended on the given cell, in order of distance so parents are settled first, and then
+     * fills the lost region back in from its edges
      *
-     * @param Index
-     * @return Int4
+     * @param maze
+     * @param root
      */
-    Int4 GetNeighbours(int Index) {
-        Int4 neighbours;
-        Vector2i Coordinates = returnCoordinates(Index);
-        if (Coordinates.y - 1 >= 0 && !(grid[Index].GetWallConfig().x)) {
-            neighbours.Top_present = true;
-            neighbours.Top = (Coordinates.y - 1) * CELLCOUNT + Coordinates.x;
+    void repairFrom(const PackedMaze &maze, int root) {
+        _changed.clear();
+        _queue.clear();
+        _queue.push_back(root);
+        for (size_t head = 0; head < _queue.size(); head++) {
+            int current = _queue[head];
+            if (_sourceCount[current] > 0 || _distance[current] == UNREACHABLE) {
+                continue;
+            }
+            uint32_t oldDistance = _distance[current];
+            int open = maze.OpenMask(current);
+            bool supported = false;
+            for (int direction = 0; direction < 4 && !supported; direction++) {
+                if ((open >> direction) & 1) {
+                    supported = (_distance[maze.Neighbour(current, direction)] + 1 == oldDistance);
+                }
+            }
+            if (supported) {
+                continue;
+            }
+            _distance[current] = UNREACHABLE;
+            _changed.push_back(current);
+            for (int direction = 0; direction < 4; direction++) {
+                if ((open >> direction) & 1) {
+                    int next = maze.Neighbour(current, direction);
+                    if (_distance[next] == oldDistance + 1) {
+                        _queue.push_back(next);
+                    }
+                }
+            }
         }
-        if (Coordinates.y + 1 < CELLCOUNT && !(grid[Index].GetWallConfig().z)) {
-            neighbours.Bottom_present = true;
-            neighbours.Bottom = (Coordinates.y + 1) * CELLCOUNT + Coordinates.x;
+        _queue.clear();
+
+        // Seed the lost cells from the cells around them that kept their distance, closest first
+        _seeds.clear();
+        for (size_t i = 0; i < _changed.size(); i++) {
+            int current = _changed[i];
+            int open = maze.OpenMask(current);
+            uint32_t best = UNREACHABLE;
+            for (int direction = 0; direction < 4; direction++) {
+                if ((open >> direction) & 1) {
+                    best = min(best, _distance[maze.Neighbour(current, direction)]);
+                }
+            }
+            if (best != UNREACHABLE) {
+                _seeds.push_back(make_pair(best + 1, current));
+            }
         }
-        if (Coordinates.x - 1 >= 0 && !(grid[Index].GetWallConfig().w)) {
-            neighbours.Left_present = true;
-            neighbours.Left = Coordinates.y * CELLCOUNT + (Coordinates.x - 1);
+        sort(_seeds.begin(), _seeds.end());
+
+        // Breadth first search that merges the sorted seeds with the queue, a seed can still lower a cell reached through the queue
+        size_t nextSeed = 0;
+        size_t head = 0;
+        while (nextSeed < _seeds.size() || head < _queue.size()) {
+            int current;
+            uint32_t distance;
+            if (head == _queue.size() || (nextSeed < _seeds.size() && _seeds[nextSeed].first <= _distance[_queue[head]])) {
+                current = _seeds[nextSeed].second;
+                distance = _seeds[nextSeed].first;
+                nextSeed++;
+                if (distance >= _distance[current]) {
+                    continue;
+                }
+                _distance[current] = distance;
+            } else {
+                current = _queue[head++];
+                distance = _distance[current];
+            }
+            int open = maze.OpenMask(current);
+            for (int direction = 0; direction < 4; direction++) {
+                if ((open >> direction) & 1) {
+                    int next = maze.Neighbour(current, direction);
+                    if (distance + 1 < _distance[next]) {
+                        _distance[next] = distance + 1;
+                        _queue.push_back(next);
+                    }
+                }
+            }
         }
-        if (Coordinates.x + 1 < CELLCOUNT && !(grid[Index].GetWallConfig().y)) {
-            neighbours.Right_present = true;
-            neighbours.Right = Coordinates.y * CELLCOUNT + (Coordinates.x + 1);
+        _queue.clear();
+    }
+
+   public:
+    enum : uint32_t { UNREACHABLE = 0xFFFFFFFF };  // Distance of a cell that has no path to a source
+
+    /**
+     * @brief Works out the distance from every cell to the source
+     *
+     * @param maze
+     * @param source
+     */
+    void Compute(const PackedMaze &maze, int source) {
+        _distance.assign(maze.CellCount(), UNREACHABLE);
+        _sourceCount.assign(maze.CellCount(), 0);
+        AddSource(maze, source);
+    }
+
+    /**
+     * @brief Works out the distance from every cell to the nearest of several sources in a single breadth first search
+     *
+     * @param maze
+     * @param sources
+     */
+    void Compute(const PackedMaze &maze, const vector<int> &sources) {
+        _distance.assign(maze.CellCount(), UNREACHABLE);
+        _sourceCount.assign(maze.CellCount(), 0);
+        _queue.clear();
+        for (size_t i = 0; i < sources.size(); i++) {
+            _sourceCount[sources[i]]++;
+            _distance[sources[i]] = 0;
+            _queue.push_back(sources[i]);
         }
-        return neighbours;
+        relax(maze);
     }
 
     /**
-     * @brief Get the Cell States of the neighbouring cells
+     * @brief Adds a source, distances can only shrink so only the cells that get closer are visited
      *
-     * @param Index
-     * @return Bool4
+     * @param maze
+     * @param index
      */
-    Bool4 GetCellStates(int Index) {
-        Bool4 neighbours;
-        Vector2i Coordinates = returnCoordinates(Index);
-        if (Coordinates.y - 1 >= 0) {
-            if (grid[Coordinates.y - 1].GetCellState() == 0) {
-                neighbours.x = true;
-            }
+    void AddSource(const PackedMaze &maze, int index) {
+        _sourceCount[index]++;
+        if (_distance[index] != 0) {
+            _distance[index] = 0;
+            _queue.push_back(index);
+            relax(maze);
         }
-        if (Coordinates.y + 1 < CELLCOUNT) {
-            if (grid[Coordinates.y + 1].GetCellState() == 0) {
-                neighbours.z = true;
+    }
+
+    /**
+     * @brief Removes a source, the cells that were closest to it are filled back in from the other sources
+     *
+     * @param maze
+     * @param index
+     */
+    void RemoveSource(const PackedMaze &maze, int index) {
+        _sourceCount[index]--;
+        if (_sourceCount[index] == 0) {
+            repairFrom(maze, index);
+        }
+    }
+
+    /**
+     * @brief Moves a source from one cell to another, the new cell is added first so less of the field has to be filled back in
+     *
+     * @param maze
+     * @param from
+     * @param to
+     */
+    void MoveSource(const PackedMaze &maze, int from, int to) {
+        if (from != to) {
+            AddSource(maze, to);
+            RemoveSource(maze, from);
+        }
+    }
+
+    /**
+     * @brief Returns the distance from a cell to the nearest source
+     *
+     * @param index
+     * @return uint32_t
+     */
+    uint32_t Distance(int index) const {
+        return _distance[index];
+    }
+
+    /**
+     * @brief Returns the neighbour that is one step closer to the source, or the cell itself at the source or when the source can't be reached
+     *
+     * @param maze
+     * @param index
+     * @return int
+     */
+    int NextStep(const PackedMaze &maze, int index) const {
+        if (_distance[index] == 0 || _distance[index] == UNREACHABLE) {
+            return index;
+        }
+        int open = maze.OpenMask(index);
+        for (int direction = 0; direction < 4; direction++) {
+            if ((open >> direction) & 1) {
+                int next = maze.Neighbour(index, direction);
+                if (_distance[next] + 1 == _distance[index]) {
+                    return next;
+                }
             }
         }
-        if (Coordinates.x - 1 >= 0) {
-            if (grid[Coordinates.x - 1].GetCellState() == 0) {
-                neighbours.w = true;
+        return index;
+    }
+
+    /**
+     * @brief Updates the field after a wall was removed in the maze, distances can only shrink so only the cells that get closer are visited
+     *
+     * @param maze
+     * @param index
+     * @param direction
+     */
+    void WallRemoved(const PackedMaze &maze, int index, int direction) {
+        int other = maze.Neighbour(index, direction);
+        _queue.push_back(index);
+        _queue.push_back(other);
+        relax(maze);
+    }
+
+    /**
+     * @brief Updates the field after a wall was added in the maze. Cells that no longer have a neighbour one step closer lose their distance,
+     * then the lost region is filled back in from its edges in order of distance
+     *
+     * @param maze
+     * @param index
+     * @param direction
+     */
+    void WallAdded(const PackedMaze &maze, int index, int direction) {
+        int other = maze.Neighbour(index, direction);
+        if (_distance[index] == _distance[other]) {
+            return;
+        }
+        int farther = (_distance[index] > _distance[other]) ? index : other;
+        repairFrom(maze, farther);
+    }
+};
+
+/**
+ * @brief Direction to step from every cell to reach one target cell and how far away it is, filled in by a single breadth first search from
+ * the target. Any number of followers can then chase the target with one lookup each, so pursuit costs the same no matter how many are
+ * chasing
+ *
+ */
+class FlowField {
+   private:
+    vector<uint8_t> _direction;  // Direction to step from each cell towards the target, NOWHERE at the target or when it can't be reached
+    vector<uint32_t> _distance;  // Steps from each cell to the target, UNREACHABLE if there is no path
+    vector<int> _queue;          // Cells waiting to be expanded during the search
+    int _target;                 // Cell the field leads to, -1 before the first search
+
+   public:
+    enum : uint8_t { NOWHERE = 4 };
+    enum : uint32_t { UNREACHABLE = 0xFFFFFFFF };
+
+    /**
+     * @brief Construct a new FlowField object that leads nowhere until it's computed
+     *
+     */
+    FlowField() {
+        _target = -1;
+    }
+
+    /**
+     * @brief Works out the direction and distance from every cell to the target, each cell points back along the edge it was first reached
+     * through
+     *
+     * @param maze
+     * @param target
+     */
+    void Compute(const PackedMaze &maze, int target) {
+        _direction.assign(maze.CellCount(), NOWHERE);
+        _distance.assign(maze.CellCount(), UNREACHABLE);
+        _queue.resize(maze.CellCount());
+        _target = target;
+        int head = 0;
+        int tail = 0;
+        _distance[target] = 0;
+        _queue[tail++] = target;
+        while (head < tail) {
+            int current = _queue[head++];
+            int open = maze.OpenMask(current);
+            for (int direction = 0; direction < 4; direction++) {
+                if (!((open >> direction) & 1)) {
+                    continue;
+                }
+                int next = maze.Neighbour(current, direction);
+                if (_distance[next] == UNREACHABLE) {
+                    _direction[next] = (direction + 2) & 3;
+                    _distance[next] = _distance[current] + 1;
+                    _queue[tail++] = next;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the cell the field leads to
+     *
+     * @return int
+     */
+    int Target() const { return _target; }
+
+    /**
+     * @brief Returns the direction to step from a cell towards the target, NOWHERE at the target or when it can't be reached
+     *
+     * @param index
+     * @return int
+     */
+    int Direction(int index) const { return _direction[index]; }
+
+    /**
+     * @brief Returns the number of steps from a cell to the target, UNREACHABLE if there is no path
+     *
+     * @param index
+     * @return uint32_t
+     */
+    uint32_t Distance(int index) const { return _distance[index]; }
+
+    /**
+     * @brief Returns the neighbour one step closer to the target, or the cell itself at the target or when the target can't be reached
+     *
+     * @param maze
+     * @param index
+     * @return int
+     */
+    int NextStep(const PackedMaze &maze, int index) const {
+        int direction = _direction[index];
+        return (direction == NOWHERE) ? index : maze.Neighbour(index, direction);
+    }
+};
+
+/**
+ * @brief Constant time distance queries between any two cells of a perfect maze. The maze is a spanning tree so the distance between two cells
+ * is depth(a) + depth(b) - 2 * depth(lca). The lowest common ancestor comes from a range minimum query over the Euler tour of the tree, answered
+ * with a sparse table over blocks of 32 tour positions and a bit mask of the minimum stack inside each block. If the maze has loops the index
+ * works on a spanning tree of it, so distances are then only an upper bound
+ *
+ */
+class TreeDistanceIndex {
+   private:
+    vector<uint32_t> _euler;         // Cells in the order the depth first walk enters and returns to them
+    vector<uint32_t> _depth;         // Steps from the root to each cell, UNREACHABLE if the cell is not connected to it
+    vector<uint32_t> _first;         // First position of each cell in the Euler tour
+    vector<uint32_t> _last;          // Last position of each cell in the Euler tour
+    vector<uint32_t> _inBlock;       // Per tour position, bit j is set when position j of its block is the minimum of everything from j to it
+    vector<uint32_t> _sparse;        // Sparse table of the position of the smallest depth over 2^level blocks, one row per level
+    vector<pair<int, int> > _stack;  // Cell and next direction to try during the depth first walk
+    int _blockCount;                 // Number of 32 position blocks in the tour
+
+    uint32_t depthAt(uint32_t position) const { return _depth[_euler[position]]; }
+
+    uint32_t shallower(uint32_t a, uint32_t b) const { return (depthAt(b) < depthAt(a)) ? b : a; }
+
+    /**
+     * @brief Position of the smallest depth between two tour positions of the same block
+     *
+     * @param left
+     * @param right
+     * @return uint32_t
+     */
+    uint32_t inBlockMinimum(uint32_t left, uint32_t right) const {
+        return left + __builtin_ctz(_inBlock[right] >> (left & 31));
+    }
+
+    /**
+     * @brief Position of the smallest depth between two tour positions
+     *
+     * @param left
+     * @param right
+     * @return uint32_t
+     */
+    uint32_t minimum(uint32_t left, uint32_t right) const {
+        uint32_t leftBlock = left >> 5;
+        uint32_t rightBlock = right >> 5;
+        if (leftBlock == rightBlock) {
+            return inBlockMinimum(left, right);
+        }
+        uint32_t best = shallower(inBlockMinimum(left, (leftBlock << 5) + 31), inBlockMinimum(rightBlock << 5, right));
+        if (leftBlock + 1 < rightBlock) {
+            uint32_t span = rightBlock - leftBlock - 1;
+            int level = 31 - __builtin_clz(span);
+            best = shallower(best, _sparse[level * _blockCount + leftBlock + 1]);
+            best = shallower(best, _sparse[level * _blockCount + rightBlock - (1u << level)]);
+        }
+        return best;
+    }
+
+    /**
+     * @brief Builds the in block masks and the sparse table over the block minimums
+     *
+     */
+    void buildRangeMinimum() {
+        uint32_t length = _euler.size();
+        _inBlock.resize(length);
+        _blockCount = (length + 31) >> 5;
+        uint32_t mask = 0;
+        for (uint32_t i = 0; i < length; i++) {
+            if ((i & 31) == 0) {
+                mask = 0;
+            }
+            // Pop every earlier position in the block that is not smaller than this one, the top of the stack is the highest bit
+            while (mask != 0 && depthAt((i & ~31u) + 31 - __builtin_clz(mask)) >= depthAt(i)) {
+                mask &= ~(1u << (31 - __builtin_clz(mask)));
+            }
+            mask |= 1u << (i & 31);
+            _inBlock[i] = mask;
+        }
+
+        int levels = 1;
+        while ((1 << levels) <= _blockCount) {
+            levels++;
+        }
+        _sparse.resize((size_t)levels * _blockCount);
+        for (int block = 0; block < _blockCount; block++) {
+            uint32_t end = min(length - 1, (uint32_t)(block << 5) + 31);
+            _sparse[block] = inBlockMinimum(block << 5, end);
+        }
+        for (int level = 1; level < levels; level++) {
+            for (int block = 0; block + (1 << level) <= _blockCount; block++) {
+                _sparse[level * _blockCount + block] = shallower(_sparse[(level - 1) * _blockCount + block], _sparse[(level - 1) * _blockCount + block + (1 << (level - 1))]);
+            }
+        }
+    }
+
+   public:
+    enum : uint32_t { UNREACHABLE = 0xFFFFFFFF };  // Distance between cells that are not connected
+
+    /**
+     * @brief Construct a new TreeDistanceIndex object
+     *
+     */
+    TreeDistanceIndex() {
+        _blockCount = 0;
+    }
+
+    /**
+     * @brief Walks the maze depth first from the root to record the Euler tour and depths and then builds the range minimum structure
+     *
+     * @param maze
+     * @param root
+     */
+    void Build(const PackedMaze &maze, int root) {
+        _depth.assign(maze.CellCount(), UNREACHABLE);
+        _first.resize(maze.CellCount());
+        _last.resize(maze.CellCount());
+        _euler.clear();
+        _stack.clear();
+
+        _depth[root] = 0;
+        _first[root] = 0;
+        _euler.push_back(root);
+        _stack.push_back(make_pair(root, 0));
+        while (!_stack.empty()) {
+            int current = _stack.back().first;
+            int direction = _stack.back().second;
+            if (direction == 4) {
+                _last[current] = _euler.size() - 1;
+                _stack.pop_back();
+                if (!_stack.empty()) {
+                    _euler.push_back(_stack.back().first);
+                }
+                continue;
+            }
+            _stack.back().second++;
+            if (maze.IsOpen(current, direction)) {
+                int next = maze.Neighbour(current, direction);
+                if (_depth[next] == UNREACHABLE) {
+                    _depth[next] = _depth[current] + 1;
+                    _first[next] = _euler.size();
+                    _euler.push_back(next);
+                    _stack.push_back(make_pair(next, 0));
+                }
+            }
+        }
+        buildRangeMinimum();
+    }
+
+    /**
+     * @brief Returns the lowest common ancestor of two connected cells
+     *
+     * @param a
+     * @param b
+     * @return int
+     */
+    int CommonAncestor(int a, int b) const {
+        return _euler[minimum(min(_first[a], _first[b]), max(_first[a], _first[b]))];
+    }
+
+    /**
+     * @brief Returns the number of steps between two cells
+     *
+     * @param a
+     * @param b
+     * @return uint32_t
+     */
+    uint32_t Distance(int a, int b) const {
+        if (_depth[a] == UNREACHABLE || _depth[b] == UNREACHABLE) {
+            return UNREACHABLE;
+        }
+        return _depth[a] + _depth[b] - 2 * _depth[CommonAncestor(a, b)];
+    }
+
+    /**
+     * @brief Returns the neighbour of a cell that is one step closer to the target. If the target is below the cell in the tree the step goes to the
+     * child whose part of the tour holds the target, otherwise it goes up to the parent
+     *
+     * @param maze
+     * @param index
+     * @param target
+     * @return int
+     */
+    int NextStep(const PackedMaze &maze, int index, int target) const {
+        if (index == target || _depth[index] == UNREACHABLE || _depth[target] == UNREACHABLE) {
+            return index;
+        }
+        bool targetBelow = _first[index] <= _first[target] && _first[target] <= _last[index];
+        int open = maze.OpenMask(index);
+        for (int direction = 0; direction < 4; direction++) {
+            if (!((open >> direction) & 1)) {
+                continue;
+            }
+            int next = maze.Neighbour(index, direction);
+            if (targetBelow) {
+                if (_depth[next] == _depth[index] + 1 && _first[next] <= _first[target] && _first[target] <= _last[next]) {
+                    return next;
+                }
+            } else if (_depth[next] + 1 == _depth[index] && _first[next] < _first[index] && _last[index] < _last[next]) {
+                return next;
+            }
+        }
+        return index;
+    }
+};
+
+/**
+ * @brief Grid object that holds the grid of cells
+ *
+ */
+class Grid : public Drawable {
+   private:
+    Stack _visitedCells;               // Stack of visited cells used during the maze generation to go back to last visited cell
+    PackedMaze _walls;                 // Packed copy of the walls kept in sync with the cells, used by the solvers
+    DistanceField _exitDistances;      // Distance from every cell to the end cell, used by the hint
+    TreeDistanceIndex _cellDistances;  // Constant time distance between any two cells, the game's mazes are always trees so it's exact
+
+    /**
+     * @brief Returns the configuration of the neighbours present for a particular cell
+     *
+     * @param Array
+     * @param CELL_ID
+     * @return Int4
+     */
+    Int4 noOfNeighbour(Cell Array[], int CELL_ID) {
+        Int4 neighbours;
+        Vector2i Coordinates = returnCoordinates(CELL_ID);
+        if (Coordinates.y - 1 >= 0 && !(Array[returnArrayIndex(Coordinates.x, Coordinates.y - 1)].visited)) {
+            neighbours.Top_present = true;
+            neighbours.Top = returnArrayIndex(Coordinates.x, Coordinates.y - 1);
+        }
+        if (Coordinates.y + 1 < CELLCOUNT && !(Array[returnArrayIndex(Coordinates.x, Coordinates.y + 1)].visited)) {
+            neighbours.Bottom_present = true;
+            neighbours.Bottom = returnArrayIndex(Coordinates.x, Coordinates.y + 1);
+        }
+        if (Coordinates.x - 1 >= 0 && !(Array[returnArrayIndex(Coordinates.x - 1, Coordinates.y)].visited)) {
+            neighbours.Left_present = true;
+            neighbours.Left = returnArrayIndex(Coordinates.x - 1, Coordinates.y);
+        }
+        if (Coordinates.x + 1 < CELLCOUNT && !(Array[returnArrayIndex(Coordinates.x + 1, Coordinates.y)].visited)) {
+            neighbours.Right_present = true;
+            neighbours.Right = returnArrayIndex(Coordinates.x + 1, Coordinates.y);
+        }
+
+        return neighbours;
+    }
+
+    /**
+     * @brief picks a random neighbour from a collection of neighbours and stores the neighbours cell index and path details and returns it
+     *
+     * @param NeighboursList
+     * @return Vector3i
+     */
+    Vector3i randomNeighbour(Int4 NeighboursList) {
+        int i = 0;
+        Vector3i List[4];
+        Vector3i ReturnValue(CELLCOUNT * CELLCOUNT, 0, 0);  // CellID | From | To
+        if (NeighboursList.Bottom_present) {
+            List[i].x = NeighboursList.Bottom;
+            List[i].y = 2;
+            List[i].z = 0;
+            i++;
+        }
+        if (NeighboursList.Top_present) {
+            List[i].x = NeighboursList.Top;
+            List[i].y = 0;
+            List[i].z = 2;
+            i++;
+        }
+        if (NeighboursList.Left_present) {
+            List[i].x = NeighboursList.Left;
+            List[i].y = 3;
+            List[i].z = 1;
+            i++;
+        }
+        if (NeighboursList.Right_present) {
+            List[i].x = NeighboursList.Right;
+            List[i].y = 1;
+            List[i].z = 3;
+            i++;
+        }
+        if (i == 0) {
+            return ReturnValue;
+        }
+        random_shuffle(&List[0], &List[i]);
+        ReturnValue = List[rand() % i];
+        return ReturnValue;
+    }
+
+    /**
+     * @brief runs a backtracking maze generation algorithm to create a maze in a 2D grid
+     *
+     */
+    void GenerateMaze() {
+        srand(time(NULL));
+        int No_Visited_Cells = CELLCOUNT * CELLCOUNT;
+        int Previous_Cell_ID = returnArrayIndex(rand() % CELLCOUNT, rand() % CELLCOUNT);
+
+        while (No_Visited_Cells != 0) {
+            Int4 Neighbours = noOfNeighbour(grid.data(), Previous_Cell_ID);
+            Vector3i Cell_Number = randomNeighbour(Neighbours);
+            if (Cell_Number.x == CELLCOUNT * CELLCOUNT) {
+                grid[Previous_Cell_ID].visited = true;
+                Previous_Cell_ID = _visitedCells.Pop();
+                --No_Visited_Cells;
+            } else {
+                grid[Cell_Number.x].visited = true;
+                grid[Previous_Cell_ID].RemoveWall(Cell_Number.y);
+                grid[Cell_Number.x].RemoveWall(Cell_Number.z);
+                _walls.RemoveWall(Previous_Cell_ID, Cell_Number.y);
+                _visitedCells.Push(Cell_Number.x);
+                Previous_Cell_ID = Cell_Number.x;
+            }
+        }
+    }
+
+    /**
+     * @brief Draws every cell with its walls
+     *
+     * @param target
+     * @param states
+     */
+    void draw(RenderTarget &target, RenderStates states) const override {
+        for (int i = 0; i < CELLCOUNT * CELLCOUNT; i++) {
+            target.draw(grid[i], states);
+        }
+    }
+
+   public:
+    vector<Cell> grid;  // Main grid of the maze, kept on the heap so large mazes don't overflow the stack
+
+    /**
+     * @brief Construct a new Grid object
+     *
+     */
+    Grid() : grid(CELLCOUNT * CELLCOUNT) {
+        int xPos = 0;
+        int yPos = 0;
+        for (int x = 0; x < CELLCOUNT; x++) {
+            for (int y = 0; y < CELLCOUNT; y++) {
+                int cellID = x * CELLCOUNT + y;
+                grid[cellID] = Cell(xPos, yPos, CELLCOUNT, CELLCOUNT, Color::Black);
+                xPos += CELLSIZE;
+            }
+            yPos += CELLSIZE;
+            xPos = 0;
+        }
+        GenerateMaze();
+        // Setting the first and last cell to be the start and end points
+        grid[0].SetState(1);
+        grid[(CELLCOUNT * CELLCOUNT) - 1].SetState(2);
+        _exitDistances.Compute(_walls, (CELLCOUNT * CELLCOUNT) - 1);
+        _cellDistances.Build(_walls, 0);
+    }
+
+    /**
+     * @brief Get the Neighbours from a cells index
+     *
+     * @param Index
+     * @return Int4
+     */
+    Int4 GetNeighbours(int Index) {
+        return _walls.GetNeighbours(Index);
+    }
+
+    /**
+     * @brief Get the Cell States of the neighbouring cells
+     *
+     * @param Index
+     * @return Bool4
+     */
+    Bool4 GetCellStates(int Index) {
+        Bool4 neighbours;
+        Vector2i Coordinates = returnCoordinates(Index);
+        if (Coordinates.y - 1 >= 0) {
+            if (grid[returnArrayIndex(Coordinates.x, Coordinates.y - 1)].GetCellState() == 0) {
+                neighbours.x = true;
+            }
+        }
+        if (Coordinates.y + 1 < CELLCOUNT) {
+            if (grid[returnArrayIndex(Coordinates.x, Coordinates.y + 1)].GetCellState() == 0) {
+                neighbours.z = true;
+            }
+        }
+        if (Coordinates.x - 1 >= 0) {
+            if (grid[returnArrayIndex(Coordinates.x - 1, Coordinates.y)].GetCellState() == 0) {
+                neighbours.w = true;
+            }
+        }
+        if (Coordinates.x + 1 < CELLCOUNT) {
+            if (grid[returnArrayIndex(Coordinates.x + 1, Coordinates.y)].GetCellState() == 0) {
+                neighbours.y = true;
+            }
+        }
+        return neighbours;
+    }
+
+    /**
+     * @brief Returns the neighbouring cell that leads towards the end cell, used for the hint
+     *
+     * @param Index
+     * @return int
+     */
+    int NextStepToExit(int Index) {
+        return _exitDistances.NextStep(_walls, Index);
+    }
+
+    /**
+     * @brief Returns the packed walls of the maze
+     *
+     * @return const PackedMaze&
+     */
+    const PackedMaze &GetWalls() {
+        return _walls;
+    }
+
+    /**
+     * @brief Returns the distance index over the maze, the hunters follow it to the player
+     *
+     * @return const TreeDistanceIndex&
+     */
+    const TreeDistanceIndex &GetCellDistances() const {
+        return _cellDistances;
+    }
+
+    /**
+     * @brief Returns a cell given its index, cells draw themselves so the cell can be passed straight to a window
+     *
+     * @param Index
+     * @return const Cell&
+     */
+    const Cell &ReturnCell(int Index) const {
+        return grid[Index];
+    }
+};
+
+////////////////GRID SETTINGS AND FUNCTIONS///////////////////////////////////
+
+////////////////SOLVER SETTINGS AND FUNCTIONS///////////////////////////////////
+
+/**
+ * @brief Breadth first solver that works directly on the packed walls. The queue is a ring buffer that only grows to the widest frontier met,
+ * visited cells are one bit each and every cell stores the direction back to its parent in 2 bits. Buffers are only allocated when the maze
+ * or the frontier grows so repeated solves do not allocate
+ *
+ */
+class BFSSolver {
+   private:
+    vector<uint32_t> _queue;    // Ring buffer of the cells waiting to be expanded, only as large as the widest frontier seen so far
+    vector<uint64_t> _visited;  // One bit per cell set once the cell has been reached
+    vector<uint64_t> _parents;  // Two bits per cell holding the direction back towards the start
+    uint32_t _queueMask;        // Ring buffer size - 1, the size is a power of two
+    int _cellCount;             // Number of cells the buffers are sized for
+    int _expanded;              // Number of cells taken off the queue during the last solve
+
+    enum : uint32_t { INITIALQUEUE = 1024 };  // Entries in the ring before its first growth
+
+    /**
+     * @brief Grows the bitsets when a larger maze is solved, the ring doesn't depend on the maze size and only grows when a frontier fills it
+     *
+     * @param cellCount
+     */
+    void reserve(int cellCount) {
+        if (_queue.empty()) {
+            _queue.resize(INITIALQUEUE);
+            _queueMask = INITIALQUEUE - 1;
+        }
+        if (cellCount <= _cellCount) {
+            return;
+        }
+        _visited.resize((cellCount + 63) / 64);
+        _parents.resize((cellCount + 31) / 32);
+        _cellCount = cellCount;
+    }
+
+    /**
+     * @brief Doubles the ring when it is full, the waiting cells are moved to the front of the larger ring in order. The ring keeps its size
+     * between solves so growth stops once it fits the widest frontier of the mazes being solved
+     *
+     * @param head
+     * @param tail
+     */
+    void growQueue(uint32_t &head, uint32_t &tail) {
+        uint32_t count = tail - head;
+        vector<uint32_t> larger(_queue.size() * 2);
+        for (uint32_t i = 0; i < count; i++) {
+            larger[i] = _queue[(head + i) & _queueMask];
+        }
+        _queue.swap(larger);
+        _queueMask = _queue.size() - 1;
+        head = 0;
+        tail = count;
+    }
+
+    bool isVisited(int index) { return (_visited[index >> 6] >> (index & 63)) & 1; }
+
+    void setVisited(int index) { _visited[index >> 6] |= (uint64_t)1 << (index & 63); }
+
+    int getParent(int index) { return (_parents[index >> 5] >> ((index & 31) * 2)) & 3; }
+
+    void setParent(int index, int direction) {
+        int shift = (index & 31) * 2;
+        _parents[index >> 5] = (_parents[index >> 5] & ~((uint64_t)3 << shift)) | ((uint64_t)direction << shift);
+    }
+
+   public:
+    /**
+     * @brief Construct a new BFSSolver object
+     *
+     */
+    BFSSolver() {
+        _queueMask = 0;
+        _cellCount = 0;
+        _expanded = 0;
+    }
+
+    /**
+     * @brief Finds the shortest path from the start cell (0) to the end cell (the last cell)
+     *
+     * @param maze
+     * @param path
+     * @return true
+     * @return false
+     */
+    bool Solve(const PackedMaze &maze, vector<int> &path) {
+        return Solve(maze, 0, maze.CellCount() - 1, path);
+    }
+
+    /**
+     * @brief Finds the shortest path between two cells and writes it into path from start to goal, returns false if the goal can't be reached
+     *
+     * @param maze
+     * @param start
+     * @param goal
+     * @param path
+     * @return true
+     * @return false
+     */
+    bool Solve(const PackedMaze &maze, int start, int goal, vector<int> &path) {
+        reserve(maze.CellCount());
+        memset(_visited.data(), 0, ((maze.CellCount() + 63) / 64) * sizeof(uint64_t));
+        path.clear();
+        _expanded = 0;
+
+        uint32_t head = 0;
+        uint32_t tail = 0;
+        _queue[tail++ & _queueMask] = start;
+        setVisited(start);
+
+        bool found = (start == goal);
+        while (head != tail && !found) {
+            int current = _queue[head++ & _queueMask];
+            int open = maze.OpenMask(current);
+            _expanded++;
+            for (int direction = 0; direction < 4; direction++) {
+                if (!((open >> direction) & 1)) {
+                    continue;
+                }
+                int next = maze.Neighbour(current, direction);
+                if (isVisited(next)) {
+                    continue;
+                }
+                setVisited(next);
+                // Store the side leading back to the parent
+                setParent(next, (direction + 2) & 3);
+                if (next == goal) {
+                    found = true;
+                    break;
+                }
+                if (tail - head > _queueMask) {
+                    growQueue(head, tail);
+                }
+                _queue[tail++ & _queueMask] = next;
+            }
+        }
+
+        if (!found) {
+            return false;
+        }
+        for (int index = goal; index != start; index = maze.Neighbour(index, getParent(index))) {
+            path.push_back(index);
+        }
+        path.push_back(start);
+        reverse(path.begin(), path.end());
+        return true;
+    }
+
+    /**
+     * @brief Returns how many cells were expanded by the last solve
+     *
+     * @return int
+     */
+    int NodesExpanded() {
+        return _expanded;
+    }
+
+    /**
+     * @brief Returns the bytes held by the ring and the bitsets
+     *
+     * @return size_t
+     */
+    size_t MemoryUsed() const {
+        return _queue.size() * sizeof(uint32_t) + (_visited.size() + _parents.size()) * sizeof(uint64_t);
+    }
+};
+
+/**
+ * @brief Priority queue for small integer keys. Keys map onto a ring of buckets so push and pop are O(1), the ring only has to be wider
+ * than the largest gap between the smallest key in the queue and any key pushed while it is there
+ *
+ */
+class BucketQueue {
+   private:
+    vector<vector<uint32_t> > _buckets;  // Ring of buckets, each one used as a stack
+    int _mask;                           // Number of buckets - 1, the number of buckets is a power of two
+    int _minKey;                         // Smallest key that may still hold entries
+    int _size;                           // Number of entries in the queue
+
+   public:
+    /**
+     * @brief Construct a new BucketQueue object
+     *
+     * @param keySpan
+     */
+    BucketQueue(int keySpan) {
+        int count = 1;
+        while (count <= keySpan) {
+            count <<= 1;
+        }
+        _buckets.resize(count);
+        _mask = count - 1;
+        _minKey = 0;
+        _size = 0;
+    }
+
+    /**
+     * @brief Empties the queue while keeping the memory of the buckets
+     *
+     */
+    void Clear() {
+        for (size_t i = 0; i < _buckets.size(); i++) {
+            _buckets[i].clear();
+        }
+        _minKey = 0;
+        _size = 0;
+    }
+
+    bool Empty() { return _size == 0; }
+
+    /**
+     * @brief Pushes a value with a key that is not more than keySpan above the smallest key in the queue
+     *
+     * @param key
+     * @param value
+     */
+    void Push(int key, uint32_t value) {
+        if (_size == 0 || key < _minKey) {
+            _minKey = key;
+        }
+        _buckets[key & _mask].push_back(value);
+        _size++;
+    }
+
+    /**
+     * @brief Pops a value with the smallest key, the last value pushed with that key comes out first
+     *
+     * @param key
+     * @return uint32_t
+     */
+    uint32_t Pop(int &key) {
+        while (_buckets[_minKey & _mask].empty()) {
+            _minKey++;
+        }
+        uint32_t value = _buckets[_minKey & _mask].back();
+        _buckets[_minKey & _mask].pop_back();
+        _size--;
+        key = _minKey;
+        return value;
+    }
+};
+
+/**
+ * @brief A* solver using the Manhattan distance as the heuristic. Every step costs 1 so the estimated total only ever stays the same or grows
+ * by 2, which lets the open list be a ring of four buckets. Closed cells are one bit each and queue entries carry the side they were reached from
+ *
+ */
+class AStarSolver {
+   private:
+    BucketQueue _open;          // Open list keyed on the estimated total path length
+    vector<uint64_t> _closed;   // One bit per cell set once the cell has been expanded
+    vector<uint64_t> _parents;  // Two bits per cell holding the direction back towards the start
+    int _cellCount;             // Number of cells the buffers are sized for
+    int _expanded;              // Number of cells expanded during the last solve
+
+    void reserve(int cellCount) {
+        if (cellCount <= _cellCount) {
+            return;
+        }
+        _closed.resize((cellCount + 63) / 64);
+        _parents.resize((cellCount + 31) / 32);
+        _cellCount = cellCount;
+    }
+
+    bool isClosed(int index) { return (_closed[index >> 6] >> (index & 63)) & 1; }
+
+    void setClosed(int index) { _closed[index >> 6] |= (uint64_t)1 << (index & 63); }
+
+    int getParent(int index) { return (_parents[index >> 5] >> ((index & 31) * 2)) & 3; }
+
+    void setParent(int index, int direction) {
+        int shift = (index & 31) * 2;
+        _parents[index >> 5] = (_parents[index >> 5] & ~((uint64_t)3 << shift)) | ((uint64_t)direction << shift);
+    }
+
+    /**
+     * @brief Manhattan distance between two cells
+     *
+     * @param maze
+     * @param index
+     * @param goal
+     * @return int
+     */
+    int heuristic(const PackedMaze &maze, int index, int goal) {
+        return abs(index % maze.Width() - goal % maze.Width()) + abs(index / maze.Width() - goal / maze.Width());
+    }
+
+    /**
+     * @brief Pushes a neighbour onto the open list together with the side leading back to its parent
+     *
+     * @param maze
+     * @param next
+     * @param back
+     * @param cost
+     * @param goal
+     */
+    void open(const PackedMaze &maze, int next, int back, int cost, int goal) {
+        if (!isClosed(next)) {
+            _open.Push(cost + heuristic(maze, next, goal), ((uint32_t)next << 2) | back);
+        }
+    }
+
+   public:
+    /**
+     * @brief Construct a new AStarSolver object
+     *
+     */
+    AStarSolver() : _open(2) {
+        _cellCount = 0;
+        _expanded = 0;
+    }
+
+    /**
+     * @brief Finds the shortest path from the start cell (0) to the end cell (the last cell)
+     *
+     * @param maze
+     * @param path
+     * @return true
+     * @return false
+     */
+    bool Solve(const PackedMaze &maze, vector<int> &path) {
+        return Solve(maze, 0, maze.CellCount() - 1, path);
+    }
+
+    /**
+     * @brief Finds the shortest path between two cells and writes it into path from start to goal, returns false if the goal can't be reached
+     *
+     * @param maze
+     * @param start
+     * @param goal
+     * @param path
+     * @return true
+     * @return false
+     */
+    bool Solve(const PackedMaze &maze, int start, int goal, vector<int> &path) {
+        reserve(maze.CellCount());
+        memset(_closed.data(), 0, ((maze.CellCount() + 63) / 64) * sizeof(uint64_t));
+        _open.Clear();
+        path.clear();
+        _expanded = 0;
+
+        // The start cell is pushed with a dummy parent that is never followed
+        _open.Push(heuristic(maze, start, goal), (uint32_t)start << 2);
+        bool found = false;
+        while (!_open.Empty()) {
+            int estimate;
+            uint32_t entry = _open.Pop(estimate);
+            int current = entry >> 2;
+            if (isClosed(current)) {
+                continue;
+            }
+            setClosed(current);
+            setParent(current, entry & 3);
+            _expanded++;
+            if (current == goal) {
+                found = true;
+                break;
+            }
+
+            int cost = estimate - heuristic(maze, current, goal) + 1;
+            Int4 neighbours = maze.GetNeighbours(current);
+            if (neighbours.Top_present) {
+                open(maze, neighbours.Top, 2, cost, goal);
+            }
+            if (neighbours.Right_present) {
+                open(maze, neighbours.Right, 3, cost, goal);
+            }
+            if (neighbours.Bottom_present) {
+                open(maze, neighbours.Bottom, 0, cost, goal);
+            }
+            if (neighbours.Left_present) {
+                open(maze, neighbours.Left, 1, cost, goal);
+            }
+        }
+
+        if (!found) {
+            return false;
+        }
+        for (int index = goal; index != start; index = maze.Neighbour(index, getParent(index))) {
+            path.push_back(index);
+        }
+        path.push_back(start);
+        reverse(path.begin(), path.end());
+        return true;
+    }
+
+    /**
+     * @brief Returns how many cells were expanded by the last solve
+     *
+     * @return int
+     */
+    int NodesExpanded() {
+        return _expanded;
+    }
+};
+
+/**
+ * @brief Bidirectional breadth first solver that grows one level at a time from whichever end has the smaller frontier and stops when the two
+ * searches first touch. With whole levels expanded the first meeting is always on a shortest path. Each cell belongs to at most one side so a
+ * single 2 bit parent array serves both searches
+ *
+ */
+class BidirectionalBFSSolver {
+   private:
+    vector<int> _frontier[2];      // Cells on the current level of the forward (0) and backward (1) search
+    vector<int> _next;             // Cells found while expanding a level
+    vector<uint64_t> _visited[2];  // One bit per cell for each side
+    vector<uint64_t> _parents;     // Two bits per cell holding the direction back towards the side's root
+    int _cellCount;                // Number of cells the buffers are sized for
+    int _expanded[2];              // Number of cells expanded by each side during the last solve
+
+    void reserve(int cellCount) {
+        if (cellCount <= _cellCount) {
+            return;
+        }
+        _visited[0].resize((cellCount + 63) / 64);
+        _visited[1].resize((cellCount + 63) / 64);
+        _parents.resize((cellCount + 31) / 32);
+        _cellCount = cellCount;
+    }
+
+    bool isVisited(int side, int index) { return (_visited[side][index >> 6] >> (index & 63)) & 1; }
+
+    void setVisited(int side, int index) { _visited[side][index >> 6] |= (uint64_t)1 << (index & 63); }
+
+    int getParent(int index) { return (_parents[index >> 5] >> ((index & 31) * 2)) & 3; }
+
+    void setParent(int index, int direction) {
+        int shift = (index & 31) * 2;
+        _parents[index >> 5] = (_parents[index >> 5] & ~((uint64_t)3 << shift)) | ((uint64_t)direction << shift);
+    }
+
+    /**
+     * @brief Expands a whole level of one side, returns true and the two touching cells as soon as a cell of the other side is reached
+     *
+     * @param maze
+     * @param side
+     * @param meetingNear
+     * @param meetingFar
+     * @return true
+     * @return false
+     */
+    bool expandLevel(const PackedMaze &maze, int side, int &meetingNear, int &meetingFar) {
+        _next.clear();
+        for (size_t i = 0; i < _frontier[side].size(); i++) {
+            int current = _frontier[side][i];
+            int open = maze.OpenMask(current);
+            _expanded[side]++;
+            for (int direction = 0; direction < 4; direction++) {
+                if (!((open >> direction) & 1)) {
+                    continue;
+                }
+                int next = maze.Neighbour(current, direction);
+                if (isVisited(1 - side, next)) {
+                    meetingNear = current;
+                    meetingFar = next;
+                    return true;
+                }
+                if (isVisited(side, next)) {
+                    continue;
+                }
+                setVisited(side, next);
+                setParent(next, (direction + 2) & 3);
+                _next.push_back(next);
+            }
+        }
+        _frontier[side].swap(_next);
+        return false;
+    }
+
+   public:
+    /**
+     * @brief Construct a new BidirectionalBFSSolver object
+     *
+     */
+    BidirectionalBFSSolver() {
+        _cellCount = 0;
+        _expanded[0] = 0;
+        _expanded[1] = 0;
+    }
+
+    /**
+     * @brief Finds the shortest path from the start cell (0) to the end cell (the last cell)
+     *
+     * @param maze
+     * @param path
+     * @return true
+     * @return false
+     */
+    bool Solve(const PackedMaze &maze, vector<int> &path) {
+        return Solve(maze, 0, maze.CellCount() - 1, path);
+    }
+
+    /**
+     * @brief Finds the shortest path between two cells and writes it into path from start to goal, returns false if the goal can't be reached
+     *
+     * @param maze
+     * @param start
+     * @param goal
+     * @param path
+     * @return true
+     * @return false
+     */
+    bool Solve(const PackedMaze &maze, int start, int goal, vector<int> &path) {
+        reserve(maze.CellCount());
+        for (int side = 0; side < 2; side++) {
+            memset(_visited[side].data(), 0, ((maze.CellCount() + 63) / 64) * sizeof(uint64_t));
+            _frontier[side].clear();
+            _expanded[side] = 0;
+        }
+        path.clear();
+
+        if (start == goal) {
+            path.push_back(start);
+            return true;
+        }
+
+        _frontier[0].push_back(start);
+        _frontier[1].push_back(goal);
+        setVisited(0, start);
+        setVisited(1, goal);
+
+        int meetingNear = -1;
+        int meetingFar = -1;
+        int side = 0;
+        bool found = false;
+        while (!_frontier[0].empty() && !_frontier[1].empty()) {
+            side = (_frontier[0].size() <= _frontier[1].size()) ? 0 : 1;
+            if (expandLevel(maze, side, meetingNear, meetingFar)) {
+                found = true;
+                break;
+            }
+        }
+
+        if (!found) {
+            return false;
+        }
+
+        // meetingNear belongs to the side that was expanding and meetingFar to the other one
+        int fromStart = (side == 0) ? meetingNear : meetingFar;
+        int fromGoal = (side == 0) ? meetingFar : meetingNear;
+        for (int index = fromStart; index != start; index = maze.Neighbour(index, getParent(index))) {
+            path.push_back(index);
+        }
+        path.push_back(start);
+        reverse(path.begin(), path.end());
+        for (int index = fromGoal; index != goal; index = maze.Neighbour(index, getParent(index))) {
+            path.push_back(index);
+        }
+        path.push_back(goal);
+        return true;
+    }
+
+    /**
+     * @brief Returns how many cells were expanded by both sides during the last solve
+     *
+     * @return int
+     */
+    int NodesExpanded() {
+        return _expanded[0] + _expanded[1];
+    }
+
+    /**
+     * @brief Returns how many cells were expanded from the start during the last solve
+     *
+     * @return int
+     */
+    int ForwardNodesExpanded() {
+        return _expanded[0];
+    }
+
+    /**
+     * @brief Returns how many cells were expanded from the goal during the last solve
+     *
+     * @return int
+     */
+    int BackwardNodesExpanded() {
+        return _expanded[1];
+    }
+};
+
+/**
+ * @brief Dead end filling solver that works on whole 64 cell words of the packed walls at once. A word finds every cell with exactly one open side
+ * using bit arithmetic over its four neighbour masks and fills them, repeating until the word settles. Rows are swept alternately top down and
+ * bottom up so chains of dead ends collapse in few passes, and only rows next to a change are looked at again. Rows are split into chunks that are
+ * settled on the threads of a WorkerPool in two phases, even chunks then odd chunks, so no two threads touch neighbouring rows at the same time.
+ * Rounds repeat until no row is left active and the cells left unfilled are the solution corridor
+ *
+ */
+class DeadEndFiller {
+   private:
+    vector<uint64_t> _filled;  // Row padded bitset of the cells filled so far
+    vector<uint8_t> _active;   // Rows that may hold new dead ends because they or a neighbouring row changed
+    int _wordsPerRow;          // Number of 64 bit words in a row
+    WorkerPool *_pool;         // Threads the chunks are settled on, NULL to settle every row on the calling thread
+    int _passes;               // Number of rounds the last solve took, a round settles every chunk once
+
+    /**
+     * @brief Fills the dead ends of one row until none are left, returns true if anything was filled
+     *
+     * @param maze
+     * @param y
+     * @param start
+     * @param goal
+     * @return true
+     * @return false
+     */
+    bool fillRow(const PackedMaze &maze, int y, int start, int goal) {
+        int height = maze.Height();
+        const uint64_t *east = maze.EastRow(y);
+        const uint64_t *south = maze.SouthRow(y);
+        const uint64_t *above = (y > 0) ? maze.SouthRow(y - 1) : NULL;
+        uint64_t *filled = &_filled[(size_t)y * _wordsPerRow];
+        const uint64_t *filledAbove = (y > 0) ? filled - _wordsPerRow : NULL;
+        const uint64_t *filledBelow = (y + 1 < height) ? filled + _wordsPerRow : NULL;
+
+        // Start and goal are never filled
+        int rowStart = y * maze.Width();
+        bool changed = false;
+        bool rowChanged = true;
+        while (rowChanged) {
+            rowChanged = false;
+            for (int w = 0; w < _wordsPerRow; w++) {
+                uint64_t keep = 0;
+                if (start >= rowStart && start < rowStart + maze.Width() && (start - rowStart) >> 6 == w) {
+                    keep |= (uint64_t)1 << ((start - rowStart) & 63);
+                }
+                if (goal >= rowStart && goal < rowStart + maze.Width() && (goal - rowStart) >> 6 == w) {
+                    keep |= (uint64_t)1 << ((goal - rowStart) & 63);
+                }
+                uint64_t eastIn = (w > 0) ? east[w - 1] >> 63 : 0;
+                uint64_t up = above ? above[w] & ~filledAbove[w] : 0;
+                uint64_t down = filledBelow ? south[w] & ~filledBelow[w] : 0;
+
+                uint64_t deadEnds = 1;
+                while (deadEnds) {
+                    // Bits of the neighbouring words shifted in so the cells on the word edges see their neighbours
+                    uint64_t filledRightIn = (w + 1 < _wordsPerRow) ? filled[w + 1] << 63 : 0;
+                    uint64_t filledLeftIn = (w > 0) ? filled[w - 1] >> 63 : 0;
+                    uint64_t right = east[w] & ~((filled[w] >> 1) | filledRightIn);
+                    uint64_t left = ((east[w] << 1) | eastIn) & ~((filled[w] << 1) | filledLeftIn);
+
+                    // Exactly one of the four sides is open
+                    uint64_t upDown = up ^ down;
+                    uint64_t leftRight = left ^ right;
+                    uint64_t twoOrMore = (up & down) | (left & right) | (upDown & leftRight);
+                    deadEnds = (upDown ^ leftRight) & ~twoOrMore & ~filled[w] & ~keep;
+                    if (deadEnds) {
+                        filled[w] |= deadEnds;
+                        // A fill on the first bit can turn the last bit of the word before into a dead end
+                        rowChanged = rowChanged || (w > 0 && (deadEnds & 1));
+                        changed = true;
+                    }
+                }
+            }
+        }
+        return changed;
+    }
+
+    /**
+     * @brief Sweeps the active rows of a chunk alternately down and up until none are left, rows that change wake their neighbours which may
+     * belong to the next chunk and are then picked up in a later round
+     *
+     * @param maze
+     * @param firstRow
+     * @param lastRow
+     * @param start
+     * @param goal
+     */
+    void settleRows(const PackedMaze &maze, int firstRow, int lastRow, int start, int goal) {
+        bool downwards = true;
+        while (find(_active.begin() + firstRow, _active.begin() + lastRow, 1) != _active.begin() + lastRow) {
+            for (int i = firstRow; i < lastRow; i++) {
+                int y = downwards ? i : firstRow + lastRow - 1 - i;
+                if (!_active[y]) {
+                    continue;
+                }
+                _active[y] = 0;
+                if (fillRow(maze, y, start, goal)) {
+                    if (y > 0) {
+                        _active[y - 1] = 1;
+                    }
+                    if (y + 1 < maze.Height()) {
+                        _active[y + 1] = 1;
+                    }
+                }
+            }
+            downwards = !downwards;
+        }
+    }
+
+   public:
+    /**
+     * @brief Construct a new DeadEndFiller object, when a pool is given large mazes are settled on its threads
+     *
+     * @param pool
+     */
+    DeadEndFiller(WorkerPool *pool = NULL) {
+        _pool = pool;
+        _wordsPerRow = 0;
+        _passes = 0;
+    }
+
+    /**
+     * @brief Fills the dead ends between the start cell (0) and the end cell (the last cell)
+     *
+     * @param maze
+     */
+    void Solve(const PackedMaze &maze) {
+        Solve(maze, 0, maze.CellCount() - 1);
+    }
+
+    /**
+     * @brief Fills every dead end of the maze leaving only the corridor that joins start and goal
+     *
+     * @param maze
+     * @param start
+     * @param goal
+     */
+    void Solve(const PackedMaze &maze, int start, int goal) {
+        int height = maze.Height();
+        _wordsPerRow = maze.WordsPerRow();
+        _filled.assign((size_t)_wordsPerRow * height, 0);
+        _active.assign(height, 1);
+        _passes = 0;
+
+        // Threads only pay off once there are enough words to share, every chunk keeps at least two rows
+        int threads = (_pool != NULL && (size_t)_wordsPerRow * height >= 4096) ? max(1, min(_pool->ThreadCount(), height / 4)) : 1;
+        int chunks = threads * 2;
+        while (find(_active.begin(), _active.end(), 1) != _active.end()) {
+            if (threads == 1) {
+                settleRows(maze, 0, height, start, goal);
+            } else {
+                // Worker w settles chunk 2w + phase, workers past the number of chunks sit the phase out
+                for (int phase = 0; phase < 2; phase++) {
+                    _pool->Run([&](int worker) {
+                        if (worker < threads) {
+                            int chunk = 2 * worker + phase;
+                            settleRows(maze, height * chunk / chunks, height * (chunk + 1) / chunks, start, goal);
+                        }
+                    });
+                }
+            }
+            _passes++;
+        }
+    }
+
+    /**
+     * @brief Checks whether a cell is left on the solution corridor after the last solve
+     *
+     * @param maze
+     * @param index
+     * @return true
+     * @return false
+     */
+    bool OnSolution(const PackedMaze &maze, int index) const {
+        int x = index % maze.Width();
+        int y = index / maze.Width();
+        return !((_filled[(size_t)y * _wordsPerRow + (x >> 6)] >> (x & 63)) & 1);
+    }
+
+    /**
+     * @brief Returns the row padded bitset of filled cells, the clear bits of real cells make up the solution mask
+     *
+     * @return const vector<uint64_t>&
+     */
+    const vector<uint64_t> &FilledMask() const {
+        return _filled;
+    }
+
+    /**
+     * @brief Returns how many rounds the last solve took
+     *
+     * @return int
+     */
+    int Passes() const {
+        return _passes;
+    }
+};
+
+/**
+ * @brief Level synchronous breadth first search for very large mazes. Each level's frontier is split between the threads of a WorkerPool, cells are
+ * claimed with an atomic OR on the visited bitset and every thread collects the next level in its own buffer. The buffers are then copied into
+ * the next frontier at offsets taken from a prefix sum so no locks are needed. When the open sides of the frontier are a large enough part of the
+ * open sides still unexplored the search switches to bottom up steps where every unvisited cell looks for a neighbour on the current level
+ * instead. A frontier on a 2D maze only grows with the square root of the cell count so the default ratio rarely switches, a higher ratio or
+ * ALWAYSBOTTOMUP switches sooner. Levels are settled one at a time so the distances are the same as the serial search
+ *
+ */
+class ParallelBFS {
+   private:
+    WorkerPool &_pool;                // Threads shared with the rest of the tooling
+    vector<uint32_t> _distance;       // Steps from the source to each cell, UNREACHABLE if there is no path
+    vector<uint64_t> _visited;        // One bit per cell, set with atomic operations
+    vector<int> _frontier;            // Cells on the current level
+    vector<int> _next;                // Cells on the next level, merged from the thread buffers
+    vector<vector<int> > _localNext;  // Cells found by each thread during a level
+    vector<size_t> _offsets;          // Where each thread's buffer goes in the next frontier
+    long long _bottomUpRatio;         // Bottom up is used when the frontier's open sides times this exceed the unexplored open sides
+    int _levels;                      // Number of levels the last search took
+    int _bottomUpLevels;              // Number of those levels that were expanded bottom up
+
+    bool claim(int index) {
+        uint64_t mask = (uint64_t)1 << (index & 63);
+        return !(__atomic_fetch_or(&_visited[index >> 6], mask, __ATOMIC_RELAXED) & mask);
+    }
+
+    uint32_t loadDistance(int index) const { return __atomic_load_n(&_distance[index], __ATOMIC_RELAXED); }
+
+    /**
+     * @brief Expands a share of the frontier, every newly reached cell is claimed by exactly one thread
+     *
+     * @param maze
+     * @param worker
+     * @param workers
+     * @param level
+     */
+    void topDown(const PackedMaze &maze, int worker, int workers, uint32_t level) {
+        vector<int> &found = _localNext[worker];
+        found.clear();
+        size_t first = _frontier.size() * worker / workers;
+        size_t last = _frontier.size() * (worker + 1) / workers;
+        for (size_t i = first; i < last; i++) {
+            int current = _frontier[i];
+            int open = maze.OpenMask(current);
+            for (int direction = 0; direction < 4; direction++) {
+                if ((open >> direction) & 1) {
+                    int next = maze.Neighbour(current, direction);
+                    if (claim(next)) {
+                        __atomic_store_n(&_distance[next], level + 1, __ATOMIC_RELAXED);
+                        found.push_back(next);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Checks a share of all cells, an unvisited cell with an open side to the current level joins the next level
+     *
+     * @param maze
+     * @param worker
+     * @param workers
+     * @param level
+     */
+    void bottomUp(const PackedMaze &maze, int worker, int workers, uint32_t level) {
+        vector<int> &found = _localNext[worker];
+        found.clear();
+        // Shares are split on whole words so no two threads write the same visited word
+        int words = _visited.size();
+        int firstWord = (int)((long long)words * worker / workers);
+        int lastWord = (int)((long long)words * (worker + 1) / workers);
+        for (int word = firstWord; word < lastWord; word++) {
+            // Walk only the unvisited bits of the word, bits past the last cell are skipped
+            uint64_t unseen = ~_visited[word];
+            if (word == words - 1 && (maze.CellCount() & 63)) {
+                unseen &= ((uint64_t)1 << (maze.CellCount() & 63)) - 1;
+            }
+            while (unseen) {
+                int index = word * 64 + __builtin_ctzll(unseen);
+                unseen &= unseen - 1;
+                int open = maze.OpenMask(index);
+                for (int direction = 0; direction < 4; direction++) {
+                    if (((open >> direction) & 1) && loadDistance(maze.Neighbour(index, direction)) == level) {
+                        _visited[word] |= (uint64_t)1 << (index & 63);
+                        __atomic_store_n(&_distance[index], level + 1, __ATOMIC_RELAXED);
+                        found.push_back(index);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+   public:
+    enum : uint32_t { UNREACHABLE = 0xFFFFFFFF };                // Distance of a cell that has no path to the source
+    enum : int { BOTTOMUPRATIO = 14, ALWAYSBOTTOMUP = 0x7FFFFFFF };  // Default switching ratio, and a ratio that expands every level bottom up
+
+    /**
+     * @brief Construct a new ParallelBFS object that runs on the given pool, the ratio sets how soon the search switches to bottom up steps
+     *
+     * @param pool
+     * @param bottomUpRatio
+     */
+    ParallelBFS(WorkerPool &pool, int bottomUpRatio = BOTTOMUPRATIO) : _pool(pool) {
+        _bottomUpRatio = bottomUpRatio;
+        _levels = 0;
+        _bottomUpLevels = 0;
+    }
+
+    /**
+     * @brief Works out the distance from the source to every cell
+     *
+     * @param maze
+     * @param source
+     */
+    void Compute(const PackedMaze &maze, int source) {
+        int workers = _pool.ThreadCount();
+        int cellCount = maze.CellCount();
+        _distance.assign(cellCount, UNREACHABLE);
+        _visited.assign((cellCount + 63) / 64, 0);
+        _localNext.resize(workers);
+        _offsets.resize(workers + 1);
+        _frontier.clear();
+        _levels = 0;
+        _bottomUpLevels = 0;
+
+        _distance[source] = 0;
+        _visited[source >> 6] |= (uint64_t)1 << (source & 63);
+        _frontier.push_back(source);
+
+        // Every open passage counts once from each of its two cells
+        long long unexploredSides = 0;
+        for (int y = 0; y < maze.Height(); y++) {
+            for (int w = 0; w < maze.WordsPerRow(); w++) {
+                unexploredSides += 2 * (__builtin_popcountll(maze.EastRow(y)[w]) + __builtin_popcountll(maze.SouthRow(y)[w]));
+            }
+        }
+        long long frontierSides = __builtin_popcount(maze.OpenMask(source));
+        unexploredSides -= frontierSides;
+
+        uint32_t level = 0;
+        while (!_frontier.empty()) {
+            // Bottom up pays off once the frontier's sides are a good part of what is left, small frontiers are not worth waking the pool for
+            bool useBottomUp = _bottomUpRatio == ALWAYSBOTTOMUP || (_frontier.size() >= 4096 && frontierSides * _bottomUpRatio > unexploredSides);
+            if (useBottomUp) {
+                _pool.Run([&](int worker) { bottomUp(maze, worker, workers, level); });
+                _bottomUpLevels++;
+            } else if (_frontier.size() >= 4096 && workers > 1) {
+                _pool.Run([&](int worker) { topDown(maze, worker, workers, level); });
+            } else {
+                topDown(maze, 0, 1, level);
+                for (int worker = 1; worker < workers; worker++) {
+                    _localNext[worker].clear();
+                }
+            }
+
+            // Merge the thread buffers, each thread copies its own part
+            _offsets[0] = 0;
+            for (int worker = 0; worker < workers; worker++) {
+                _offsets[worker + 1] = _offsets[worker] + _localNext[worker].size();
+            }
+            _next.resize(_offsets[workers]);
+            if (_next.size() >= 4096 && workers > 1) {
+                _pool.Run([&](int worker) { copy(_localNext[worker].begin(), _localNext[worker].end(), _next.begin() + _offsets[worker]); });
+            } else {
+                for (int worker = 0; worker < workers; worker++) {
+                    copy(_localNext[worker].begin(), _localNext[worker].end(), _next.begin() + _offsets[worker]);
+                }
+            }
+            _frontier.swap(_next);
+            frontierSides = 0;
+            for (size_t i = 0; i < _frontier.size(); i++) {
+                frontierSides += __builtin_popcount(maze.OpenMask(_frontier[i]));
+            }
+            unexploredSides -= frontierSides;
+            level++;
+            _levels++;
+        }
+    }
+
+    /**
+     * @brief Returns the distance from the source to a cell
+     *
+     * @param index
+     * @return uint32_t
+     */
+    uint32_t Distance(int index) const {
+        return _distance[index];
+    }
+
+    /**
+     * @brief Returns how many levels the last search took
+     *
+     * @return int
+     */
+    int Levels() const {
+        return _levels;
+    }
+
+    /**
+     * @brief Returns how many levels of the last search were expanded bottom up
+     *
+     * @return int
+     */
+    int BottomUpLevels() const {
+        return _bottomUpLevels;
+    }
+};
+
+////////////////SOLVER SETTINGS AND FUNCTIONS///////////////////////////////////
+
+////////////////ENTITY SETTINGS AND FUNCTIONS///////////////////////////////////
+
+/**
+ * @brief Index from each cell to the entities standing in it, kept as an intrusive doubly linked list per cell so moving an entity or asking
+ * who is in a cell costs the same no matter how many entities there are
+ *
+ */
+class CellOccupancy {
+   private:
+    vector<int> _head;      // First entity in each cell, -1 when the cell is empty
+    vector<int> _next;      // Next entity in the same cell, -1 at the end of a list
+    vector<int> _previous;  // Previous entity in the same cell, -1 at the start of a list
+    vector<int> _cell;      // Cell each entity is in, -1 when it isn't in the index
+
+   public:
+    /**
+     * @brief Puts an entity in a cell, an entity can only be in one cell at a time
+     *
+     * @param entity
+     * @param cell
+     */
+    void Insert(int entity, int cell) {
+        if (entity >= (int)_cell.size()) {
+            _next.resize(entity + 1, -1);
+            _previous.resize(entity + 1, -1);
+            _cell.resize(entity + 1, -1);
+        }
+        if (cell >= (int)_head.size()) {
+            _head.resize(cell + 1, -1);
+        }
+        _cell[entity] = cell;
+        _previous[entity] = -1;
+        _next[entity] = _head[cell];
+        if (_head[cell] != -1) {
+            _previous[_head[cell]] = entity;
+        }
+        _head[cell] = entity;
+    }
+
+    /**
+     * @brief Takes an entity out of the cell it's in
+     *
+     * @param entity
+     */
+    void Remove(int entity) {
+        int cell = _cell[entity];
+        if (_previous[entity] != -1) {
+            _next[_previous[entity]] = _next[entity];
+        } else {
+            _head[cell] = _next[entity];
+        }
+        if (_next[entity] != -1) {
+            _previous[_next[entity]] = _previous[entity];
+        }
+        _cell[entity] = -1;
+    }
+
+    /**
+     * @brief Moves an entity from the cell it's in to another one
+     *
+     * @param entity
+     * @param cell
+     */
+    void Move(int entity, int cell) {
+        if (_cell[entity] != cell) {
+            Remove(entity);
+            Insert(entity, cell);
+        }
+    }
+
+    /**
+     * @brief Returns the first entity in a cell, -1 when the cell is empty
+     *
+     * @param cell
+     * @return int
+     */
+    int First(int cell) const { return (cell < (int)_head.size()) ? _head[cell] : -1; }
+
+    /**
+     * @brief Returns the entity after this one in the same cell, -1 when it's the last
+     *
+     * @param entity
+     * @return int
+     */
+    int Next(int entity) const { return _next[entity]; }
+
+    /**
+     * @brief Checks whether any entity is in a cell
+     *
+     * @param cell
+     * @return true
+     * @return false
+     */
+    bool IsEmpty(int cell) const { return First(cell) == -1; }
+};
+
+/**
+ * @brief Hands out spawn cells that meet a distance constraint, each one different from the others. The eligible cells are gathered from a
+ * distance field once, then every draw swaps a random remaining cell to the end of the pool, so each spawn costs the same however many are
+ * placed
+ *
+ */
+class SpawnSampler {
+   private:
+    vector<int> _pool;  // Eligible cells, the first _remaining of them have not been handed out yet
+    vector<int> _slot;  // Position of each cell in the pool, -1 when the cell isn't eligible
+    int _remaining;     // Number of eligible cells still available
+    mt19937 _random;    // Random source for the draws
+
+    /**
+     * @brief Moves the cell at a position in the pool past the remaining cells so it can't be handed out again
+     *
+     * @param position
+     */
+    void retire(int position) {
+        _remaining--;
+        int last = _pool[_remaining];
+        int cell = _pool[position];
+        _pool[position] = last;
+        _pool[_remaining] = cell;
+        _slot[last] = position;
+        _slot[cell] = _remaining;
+    }
+
+   public:
+    /**
+     * @brief Construct a new SpawnSampler object with no eligible cells
+     *
+     * @param seed
+     */
+    SpawnSampler(unsigned seed = 0) : _random(seed) {
+        _remaining = 0;
+    }
+
+    /**
+     * @brief Makes every cell whose distance in the field lies between the two bounds eligible, cells that can't be reached never are
+     *
+     * @param field
+     * @param cellCount
+     * @param minDistance
+     * @param maxDistance
+     */
+    void Build(const DistanceField &field, int cellCount, uint32_t minDistance, uint32_t maxDistance = DistanceField::UNREACHABLE - 1) {
+        _pool.clear();
+        _slot.assign(cellCount, -1);
+        for (int cell = 0; cell < cellCount; cell++) {
+            uint32_t distance = field.Distance(cell);
+            if (distance >= minDistance && distance <= maxDistance && distance != DistanceField::UNREACHABLE) {
+                _slot[cell] = _pool.size();
+                _pool.push_back(cell);
+            }
+        }
+        _remaining = _pool.size();
+    }
+
+    /**
+     * @brief Stops a cell from being handed out, like the end cell or a cell something else already stands in
+     *
+     * @param cell
+     */
+    void Exclude(int cell) {
+        if (_slot[cell] != -1 && _slot[cell] < _remaining) {
+            retire(_slot[cell]);
+        }
+    }
+
+    /**
+     * @brief Hands out a random eligible cell that hasn't been handed out before, -1 once they have all been used
+     *
+     * @return int
+     */
+    int Take() {
+        if (_remaining == 0) {
+            return -1;
+        }
+        int position = _random() % _remaining;
+        int cell = _pool[position];
+        retire(position);
+        return cell;
+    }
+
+    /**
+     * @brief Returns the number of eligible cells that can still be handed out
+     *
+     * @return int
+     */
+    int Remaining() const { return _remaining; }
+};
+
+/**
+ * @brief Lightweight entity component system, an entity is just an index and each component is a dense array indexed by it. Systems like
+ * the transform and render passes walk the arrays in order, so there are no virtual calls or per entity drawables in the frame loop and new
+ * kinds of entities only need a team and a look rather than a new class
+ *
+ */
+class EntityWorld : public Drawable {
+   private:
+    vector<int> _cell;               // Position component, the cell each entity stands in
+    vector<Vector2f> _transform;     // Render transform component, the point each entity is drawn around
+    vector<uint8_t> _team;           // Team component, one of TEAMS
+    vector<uint8_t> _attacking;      // AI state component, 1 while an entity is red and catches the player, 0 while it can be passed through
+    vector<uint8_t> _points;         // Look component, the number of points on each entity's body
+    CellOccupancy _occupancy;        // Entities standing in each cell, kept in step with the position component
+    vector<vector<Vector2f>> _fans;  // Corners of a body with as many points as the index, around its center, shared by every such entity
+    mutable VertexArray _batch;      // Triangles of every body drawn by the last call, reused between frames
+    mutable int _drawCalls;          // Draw calls made by the last draw
+    vector<int> _dirtyCells;         // Cells whose look changed since they were last taken
+    vector<uint8_t> _cellDirty;      // 1 for every cell already in the dirty list
+
+    /**
+     * @brief Adds a cell to the dirty list unless it is already in it
+     *
+     * @param cell
+     */
+    void markDirty(int cell) {
+        if (cell >= (int)_cellDirty.size()) {
+            _cellDirty.resize(cell + 1, 0);
+        }
+        if (!_cellDirty[cell]) {
+            _cellDirty[cell] = 1;
+            _dirtyCells.push_back(cell);
+        }
+    }
+
+    /**
+     * @brief Makes sure the corners of a body with the given number of points are known. Corners sit on a circle a quarter of a cell
+     * across, starting at the top and going clockwise like the points of a CircleShape
+     *
+     * @param points
+     */
+    void addFan(int points) {
+        if (points < (int)_fans.size() && !_fans[points].empty()) {
+            return;
+        }
+        if (points >= (int)_fans.size()) {
+            _fans.resize(points + 1);
+        }
+        const float radius = CELLSIZE / 4;
+        for (int i = 0; i < points; i++) {
+            float angle = i * 2 * 3.14159265f / points - 3.14159265f / 2;
+            _fans[points].push_back(Vector2f(radius * cos(angle), radius * sin(angle)));
+        }
+    }
+
+    /**
+     * @brief Appends the triangles of the bodies of every entity standing in a cell to the batch, positions and colours come straight from
+     * the transform, team and state components. Players are yellow and enemies red while attacking and green otherwise
+     *
+     * @param cell
+     */
+    void appendCell(int cell) const {
+        for (int entity = _occupancy.First(cell); entity != -1; entity = _occupancy.Next(entity)) {
+            Color color = (_team[entity] == PLAYERTEAM) ? Color::Yellow : (_attacking[entity] ? Color::Red : Color::Green);
+            const vector<Vector2f> &fan = _fans[_points[entity]];
+            Vector2f center = _transform[entity];
+            int points = fan.size();
+            for (int i = 0; i < points; i++) {
+                _batch.append(Vertex(center, color));
+                _batch.append(Vertex(center + fan[i], color));
+                _batch.append(Vertex(center + fan[(i + 1 == points) ? 0 : i + 1], color));
+            }
+        }
+    }
+
+    /**
+     * @brief Render system, draws the bodies of the entities standing in the cells the target's view can see in a single call
+     *
+     * @param target
+     * @param states
+     */
+    void draw(RenderTarget &target, RenderStates states) const override {
+        IntRect cells = returnVisibleCells(target.getView(), CELLCOUNT, CELLCOUNT);
+        _batch.clear();
+        for (int y = cells.top; y < cells.top + cells.height; y++) {
+            for (int x = cells.left; x < cells.left + cells.width; x++) {
+                appendCell(returnArrayIndex(x, y));
+            }
+        }
+        _drawCalls = 0;
+        if (_batch.getVertexCount() > 0) {
+            target.draw(_batch, states);
+            _drawCalls = 1;
+        }
+    }
+
+   public:
+    /**
+     * @brief Sides an entity can be on
+     *
+     */
+    enum TEAMS {
+        PLAYERTEAM,
+        ENEMYTEAM
+    };
+
+    /**
+     * @brief Construct a new EntityWorld object with no entities, every entity is drawn as a half cell wide body centered on its transform
+     *
+     */
+    EntityWorld() : _batch(Triangles), _drawCalls(0) {
+    }
+
+    /**
+     * @brief Creates an entity in a cell and returns its index
+     *
+     * @param cell
+     * @param team
+     * @param points
+     * @return int
+     */
+    int Create(int cell, int team, int points) {
+        int entity = _cell.size();
+        markDirty(cell);
+        _cell.push_back(cell);
+        _transform.push_back(returnCellCenter(cell));
+        _team.push_back(team);
+        _attacking.push_back(0);
+        _points.push_back(points);
+        addFan(points);
+        _occupancy.Insert(entity, cell);
+        return entity;
+    }
+
+    /**
+     * @brief Returns the number of entities
+     *
+     * @return int
+     */
+    int Count() const { return _cell.size(); }
+
+    /**
+     * @brief Get the Cell ID or index of an entity
+     *
+     * @param entity
+     * @return int
+     */
+    int GetCellID(int entity) const { return _cell[entity]; }
+
+    /**
+     * @brief Set the Cell ID or index of an entity and moves it in the occupancy index
+     *
+     * @param entity
+     * @param cell
+     */
+    void SetCellID(int entity, int cell) {
+        markDirty(_cell[entity]);
+        markDirty(cell);
+        _cell[entity] = cell;
+        _occupancy.Move(entity, cell);
+    }
+
+    /**
+     * @brief Returns the team of an entity
+     *
+     * @param entity
+     * @return int
+     */
+    int Team(int entity) const { return _team[entity]; }
+
+    /**
+     * @brief Returns the number of points on an entity's body
+     *
+     * @param entity
+     * @return int
+     */
+    int Points(int entity) const { return _points[entity]; }
+
+    /**
+     * @brief Returns the point an entity is drawn around
+     *
+     * @param entity
+     * @return Vector2f
+     */
+    Vector2f Transform(int entity) const { return _transform[entity]; }
+
+    /**
+     * @brief Returns whether an entity is red and catches the player
+     *
+     * @param entity
+     * @return true
+     * @return false
+     */
+    bool IsAttacking(int entity) const { return _attacking[entity]; }
+
+    /**
+     * @brief Switches an entity between attacking and passive, which changes its colour
+     *
+     * @param entity
+     */
+    void SwitchState(int entity) {
+        _attacking[entity] ^= 1;
+        markDirty(_cell[entity]);
+    }
+
+    /**
+     * @brief Hands over the cells where an entity appeared, left, arrived or changed colour since the last call and starts a new list
+     *
+     * @param cells
+     */
+    void TakeDirtyCells(vector<int> &cells) {
+        for (int cell : _dirtyCells) {
+            _cellDirty[cell] = 0;
+        }
+        cells.insert(cells.end(), _dirtyCells.begin(), _dirtyCells.end());
+        _dirtyCells.clear();
+    }
+
+    /**
+     * @brief Returns the first entity in a cell, -1 when there is none
+     *
+     * @param cell
+     * @return int
+     */
+    int FirstInCell(int cell) const { return _occupancy.First(cell); }
+
+    /**
+     * @brief Returns the next entity in the same cell as this one, -1 when it's the last
+     *
+     * @param entity
+     * @return int
+     */
+    int NextInCell(int entity) const { return _occupancy.Next(entity); }
+
+    /**
+     * @brief Movement system, steps an entity through the wall on one side of its cell if that wall is open and returns the cell it ends up in
+     *
+     * @param maze
+     * @param entity
+     * @param direction
+     * @return int
+     */
+    int Move(const PackedMaze &maze, int entity, int direction) {
+        if (maze.IsOpen(_cell[entity], direction)) {
+            SetCellID(entity, maze.Neighbour(_cell[entity], direction));
+        }
+        return _cell[entity];
+    }
+
+    /**
+     * @brief Transform system, places the entities standing in a range of cells at the center of their cell. Only the cells on screen need
+     * to be passed, entities elsewhere are not drawn
+     *
+     * @param cells
+     */
+    void UpdateTransforms(const IntRect &cells) {
+        for (int y = cells.top; y < cells.top + cells.height; y++) {
+            for (int x = cells.left; x < cells.left + cells.width; x++) {
+                int cell = returnArrayIndex(x, y);
+                for (int entity = _occupancy.First(cell); entity != -1; entity = _occupancy.Next(entity)) {
+                    _transform[entity] = returnCellCenter(cell);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of draw calls made by the last draw
+     *
+     * @return int
+     */
+    int DrawCalls() const { return _drawCalls; }
+
+    /**
+     * @brief Draws the bodies of the entities standing in one cell in a single call and returns the number of calls made
+     *
+     * @param target
+     * @param cell
+     * @param states
+     * @return int
+     */
+    int DrawCell(RenderTarget &target, int cell, const RenderStates &states = RenderStates::Default) const {
+        _batch.clear();
+        appendCell(cell);
+        if (_batch.getVertexCount() == 0) {
+            return 0;
+        }
+        target.draw(_batch, states);
+        return 1;
+    }
+};
+
+////////////////ENTITY SETTINGS AND FUNCTIONS///////////////////////////////////
+
+////////////////ENEMY SETTINGS AND FUNCTIONS///////////////////////////////////
+
+/**
+ * @brief Hierarchical timing wheel that hands back events when their deadline comes up. Three wheels of 256 slots cover ticks in the current
+ * block of 256, the current block of 65536 and beyond, events further out wait in a coarser wheel and drop down a level when their block
+ * starts. Each tick looks at one slot, so advancing costs a fixed amount per tick plus one step for every event that comes due
+ *
+ */
+class TimingWheel {
+   private:
+    vector<int> _slots;          // Head of each slot's event list, LEVELS wheels of SLOTS slots back to back, -1 when a slot is empty
+    vector<int> _next;           // Next event in the same slot, -1 at the end of a list
+    vector<uint32_t> _deadline;  // Tick each event is due on
+    uint32_t _now;               // Last tick that has been processed
+
+    enum : uint32_t { LEVELS = 3, SLOTBITS = 8, SLOTS = 1 << SLOTBITS, SLOTMASK = SLOTS - 1 };
+
+    /**
+     * @brief Returns the slot of the finest wheel whose current block also holds a deadline, a waiting event is always in the slot of its
+     * deadline since cascades move events down as their blocks start
+     *
+     * @param deadline
+     * @return int
+     */
+    int slotOf(uint32_t deadline) const {
+        uint32_t level = 0;
+        while (level < LEVELS - 1 && (deadline >> (SLOTBITS * (level + 1))) != (_now >> (SLOTBITS * (level + 1)))) {
+            level++;
+        }
+        return level * SLOTS + ((deadline >> (SLOTBITS * level)) & SLOTMASK);
+    }
+
+    /**
+     * @brief Puts an event in the finest wheel whose current block also holds its deadline
+     *
+     * @param event
+     */
+    void insert(int event) {
+        int slot = slotOf(_deadline[event]);
+        _next[event] = _slots[slot];
+        _slots[slot] = event;
+    }
+
+    /**
+     * @brief Empties a slot of a coarser wheel and puts its events back in by their deadlines, which now lie in the current block
+     *
+     * @param slot
+     */
+    void cascade(int slot) {
+        int event = _slots[slot];
+        _slots[slot] = -1;
+        while (event != -1) {
+            int next = _next[event];
+            insert(event);
+            event = next;
+        }
+    }
+
+   public:
+    /**
+     * @brief Construct a new TimingWheel object with every slot empty
+     *
+     */
+    TimingWheel() {
+        _slots.assign(LEVELS * SLOTS, -1);
+        _now = 0;
+    }
+
+    /**
+     * @brief Schedules an event a number of ticks from now, an event must not be scheduled again before it has come due. Delays are capped at
+     * the span of the wheels
+     *
+     * @param event
+     * @param delay
+     */
+    void Schedule(int event, uint32_t delay) {
+        if (event >= (int)_next.size()) {
+            _next.resize(event + 1, -1);
+            _deadline.resize(event + 1, 0);
+        }
+        const uint32_t span = (1u << (SLOTBITS * LEVELS)) - SLOTS;
+        _deadline[event] = _now + max(1u, min(delay, span));
+        insert(event);
+    }
+
+    /**
+     * @brief Makes a waiting event come due at most a number of ticks from now, it's taken out of its slot and put back in by the earlier
+     * deadline. An event already due sooner is left alone
+     *
+     * @param event
+     * @param delay
+     */
+    void BringForward(int event, uint32_t delay) {
+        if (_deadline[event] - _now <= max(1u, delay)) {
+            return;
+        }
+        int *link = &_slots[slotOf(_deadline[event])];
+        while (*link != event) {
+            link = &_next[*link];
+        }
+        *link = _next[event];
+        Schedule(event, delay);
+    }
+
+    /**
+     * @brief Moves time forward a number of ticks and appends the events that came due to the list, in the order of their deadlines
+     *
+     * @param ticks
+     * @param due
+     */
+    void Advance(uint32_t ticks, vector<int> &due) {
+        for (uint32_t i = 0; i < ticks; i++) {
+            _now++;
+            if ((_now & SLOTMASK) == 0) {
+                if (((_now >> SLOTBITS) & SLOTMASK) == 0) {
+                    cascade(2 * SLOTS + ((_now >> (2 * SLOTBITS)) & SLOTMASK));
+                }
+                cascade(SLOTS + ((_now >> SLOTBITS) & SLOTMASK));
+            }
+            int slot = _now & SLOTMASK;
+            int event = _slots[slot];
+            _slots[slot] = -1;
+            while (event != -1) {
+                due.push_back(event);
+                event = _next[event];
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the last tick that has been processed
+     *
+     * @return uint32_t
+     */
+    uint32_t Now() const { return _now; }
+};
+
+/**
+ * @brief Keeps every enemy as a row across parallel arrays instead of one object each, so a tick is a tight loop over plain integers and
+ * thousands of enemies cost a few bytes apiece. Also keeps the distance from every cell to the nearest enemy up to date as they move
+ *
+ */
+class EnemySystem {
+   private:
+    EntityWorld &_world;             // Entities the enemies live in, their cells and states are the world's position and AI state components
+    vector<int> _enemies;            // Entities driven by this system
+    vector<int> _sources;            // Cells of the enemies, gathered when the distance field is searched from scratch
+    vector<int> _movePeriod;         // Milliseconds between two moves of each enemy, indexed by entity like the world's components
+    vector<int> _switchPeriod;       // Milliseconds between two switches of each enemy between red and green, indexed by entity
+    vector<uint8_t> _type;           // Behaviour of each enemy, one of ENEMYTYPES, indexed by entity
+    DistanceField _nearest;          // Distance from every cell to the nearest enemy
+    const PackedMaze *_nearestMaze;  // Maze the distance field is laid over, NULL until BuildDistances has been called
+    bool _nearestStale;              // Set when many enemies moved at once, the field is then searched again the next time it's asked for
+    FlowField _pursuit;              // Leads the hunters to the player, searched again only once the player has changed cell
+    const TreeDistanceIndex *_tree;  // Index the hunters follow instead of the flow field, NULL to search the flow field
+    int _pursuitTarget;              // Cell the hunters are chasing in the current update
+    vector<int> _moved;              // Enemies due to move in the current update, in entity order
+    vector<int> _movedFrom;          // Cell each of those enemies was in before the update
+    TimingWheel _events;             // Next move and next switch of every enemy, event 2e moves entity e and event 2e + 1 switches it
+    vector<int> _due;                // Events that came due during the current update
+    int _leftover;                   // Microseconds not yet turned into a whole tick of the wheel
+    WorkerPool *_pool;               // Threads the moves are picked on, NULL to pick them all on the calling thread
+    uint64_t _seed;                  // Seed for the moves, each draw hashes it with the enemy and the tick so no draw depends on another
+    uint32_t _updates;               // Number of updates so far, tells this update's claims on cells apart from older ones
+    vector<uint32_t> _claimed;       // Update in which each cell was last entered by a moving enemy
+    uint32_t _detailDistance;        // Steps from the player past which enemies move at reduced frequency
+    int _detailSlowdown;             // How many times longer far away enemies wait between moves
+    vector<uint8_t> _slowed;         // 0 - Not in the slowed list | 1 - Waiting at reduced frequency | 2 - Still listed but back at full speed
+    vector<int> _slowedEnemies;      // Enemies that may be waiting at reduced frequency, checked again whenever the player changes cell
+    uint8_t _moveCount[16];          // Number of sides set in each 4 bit mask of candidate sides
+    uint8_t _moveDirections[16][4];  // Sides set in each mask in order, padded with 4 which stands for staying put
+
+    enum : size_t { INCREMENTALMOVES = 8 };                 // Most moves in one update that are patched into the distance field one by one
+    enum : int { MOVEBATCH = 16, PARALLELMOVES = 4096 };  // Targets per cache line, and the fewest moves worth handing to the pool
+
+    /**
+     * @brief Targets picked by one batch of moving enemies, a batch fills a whole cache line so threads picking neighbouring batches never
+     * write to the same line
+     *
+     */
+    struct alignas(64) MoveBatch {
+        int target[MOVEBATCH];
+    };
+    vector<MoveBatch> _targets;  // Cell each moving enemy picked, in batches
+
+    /**
+     * @brief Returns a random number for an enemy's move on the current tick, the same enemy on the same tick always gets the same number
+     * whichever thread asks
+     *
+     * @param index
+     * @return uint32_t
+     */
+    uint32_t draw(int index) const {
+        uint64_t x = _seed + (uint64_t)index * 0x9E3779B97F4A7C15ull + (uint64_t)_events.Now() * 0xD1B54A32D192ED03ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return (x ^ (x >> 31)) >> 32;
+    }
+
+    /**
+     * @brief Picks the cell a wandering enemy moves to without branching on the walls. The open walls minus the sides leading to the start or
+     * end give the candidate sides, narrowed to the player's side when the player is next to the enemy, and one draw picks a side from the
+     * lookup table. An enemy with no candidates stays where it is
+     *
+     * @param maze
+     * @param index
+     * @param playerCell
+     * @return int
+     */
+    int chooseMove(const PackedMaze &maze, int index, int playerCell) const {
+        int cell = _world.GetCellID(index);
+        int width = maze.Width();
+        int last = maze.CellCount() - 1;
+        int neighbours[4] = {cell - width, cell + 1, cell + width, cell - 1};
+        int forbidden = 0;
+        int player = 0;
+        for (int direction = 0; direction < 4; direction++) {
+            forbidden |= (int)(neighbours[direction] == 0 || neighbours[direction] == last) << direction;
+            player |= (int)(neighbours[direction] == playerCell) << direction;
+        }
+        int candidates = maze.OpenMask(cell) & ~forbidden;
+        int chase = candidates & player;
+        int keep = -(int)(chase != 0);
+        candidates = (chase & keep) | (candidates & ~keep);
+        int pick = ((uint64_t)draw(index) * _moveCount[candidates]) >> 32;
+        int offsets[5] = {-width, 1, width, -1, 0};
+        return cell + offsets[_moveDirections[candidates][pick]];
+    }
+
+    /**
+     * @brief Returns the number of steps from a cell to the cell the hunters are chasing
+     *
+     * @param cell
+     * @return uint32_t
+     */
+    uint32_t pursuitDistance(int cell) const {
+        return (_tree != NULL) ? _tree->Distance(cell, _pursuitTarget) : _pursuit.Distance(cell);
+    }
+
+    /**
+     * @brief Picks the cell a hunter moves to by following the distance index or the flow field to the player, the flow field has to be
+     * searched from the player's cell already. Like every enemy, hunters never step onto the start or end
+     *
+     * @param maze
+     * @param index
+     * @return int
+     */
+    int chooseHunterMove(const PackedMaze &maze, int index) const {
+        int cell = _world.GetCellID(index);
+        int next = (_tree != NULL) ? _tree->NextStep(maze, cell, _pursuitTarget) : _pursuit.NextStep(maze, cell);
+        return (next == 0 || next == maze.CellCount() - 1) ? cell : next;
+    }
+
+    /**
+     * @brief Brings the slowed enemies that are now within the detail distance of the player back to full speed, their next move comes at
+     * most one normal period from now. Enemies that went back to full speed on their own are dropped from the list
+     *
+     */
+    void wakeNearbyEnemies() {
+        size_t kept = 0;
+        for (size_t k = 0; k < _slowedEnemies.size(); k++) {
+            int i = _slowedEnemies[k];
+            if (_slowed[i] == 1 && pursuitDistance(_world.GetCellID(i)) > _detailDistance) {
+                _slowedEnemies[kept++] = i;
+                continue;
+            }
+            if (_slowed[i] == 1) {
+                _events.BringForward(2 * i, _movePeriod[i]);
+            }
+            _slowed[i] = 0;
+        }
+        _slowedEnemies.resize(kept);
+    }
+
+    /**
+     * @brief Picks the targets of the moving enemies in a range of batches, only reads shared state so any number of ranges can run at once
+     *
+     * @param maze
+     * @param playerCell
+     * @param firstBatch
+     * @param lastBatch
+     */
+    void pickTargets(const PackedMaze &maze, int playerCell, int firstBatch, int lastBatch) {
+        int moveCount = _moved.size();
+        for (int batch = firstBatch; batch < lastBatch; batch++) {
+            int end = min(moveCount, (batch + 1) * MOVEBATCH);
+            for (int k = batch * MOVEBATCH; k < end; k++) {
+                int i = _moved[k];
+                _targets[batch].target[k - batch * MOVEBATCH] = (_type[i] == HUNTER) ? chooseHunterMove(maze, i) : chooseMove(maze, i, playerCell);
+            }
+        }
+    }
+
+   public:
+    /**
+     * @brief Behaviours an enemy can have
+     *
+     */
+    enum ENEMYTYPES {
+        WANDERER,  // Walks at random and only goes for the player when it's next to them
+        HUNTER     // Follows the shortest path to the player
+    };
+
+    /**
+     * @brief Construct a new EnemySystem object with no enemies that drives enemies in the given world, when a pool is given large updates
+     * pick their moves on it
+     *
+     * @param world
+     * @param seed
+     * @param pool
+     */
+    EnemySystem(EntityWorld &world, unsigned seed = 0, WorkerPool *pool = NULL) : _world(world) {
+        _pool = pool;
+        _seed = seed;
+        _updates = 0;
+        _leftover = 0;
+        _detailDistance = FlowField::UNREACHABLE;
+        _detailSlowdown = 1;
+        _nearestMaze = NULL;
+        _nearestStale = false;
+        _tree = NULL;
+        _pursuitTarget = -1;
+        for (int mask = 0; mask < 16; mask++) {
+            _moveCount[mask] = 0;
+            for (int direction = 0; direction < 4; direction++) {
+                _moveDirections[mask][direction] = 4;
+            }
+            for (int direction = 0; direction < 4; direction++) {
+                if (mask & (1 << direction)) {
+                    _moveDirections[mask][_moveCount[mask]++] = direction;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Creates an enemy entity in a cell and returns it, BuildDistances should be called once all the enemies are in place. The enemy
+     * moves and switches between red and green on its own periods, given in milliseconds
+     *
+     * @param cell
+     * @param type
+     * @param movePeriod
+     * @param switchPeriod
+     * @return int
+     */
+    int Spawn(int cell, int type = WANDERER, int movePeriod = 2000, int switchPeriod = 2000) {
+        int entity = _world.Create(cell, EntityWorld::ENEMYTEAM, (type == HUNTER) ? 3 : 4);
+        _enemies.push_back(entity);
+        _movePeriod.resize(entity + 1, 0);
+        _switchPeriod.resize(entity + 1, 0);
+        _type.resize(entity + 1, 0);
+        _slowed.resize(entity + 1, 0);
+        _movePeriod[entity] = movePeriod;
+        _switchPeriod[entity] = switchPeriod;
+        _type[entity] = type;
+        _events.Schedule(2 * entity, movePeriod);
+        _events.Schedule(2 * entity + 1, switchPeriod);
+        return entity;
+    }
+
+    /**
+     * @brief Sets up the AI level of detail, enemies more than the given number of steps from the player move slowdown times less often and
+     * move again within one normal period once the player comes closer. Passing FlowField::UNREACHABLE as the distance keeps every enemy at
+     * full speed
+     *
+     * @param distance
+     * @param slowdown
+     */
+    void SetLevelOfDetail(uint32_t distance, int slowdown) {
+        _detailDistance = distance;
+        _detailSlowdown = max(1, slowdown);
+    }
+
+    /**
+     * @brief Lets the hunters follow a distance index built over the same maze, so moving the player costs nothing instead of a search of
+     * the whole flow field. The index is only exact while the maze is a tree. Passing NULL goes back to the flow field
+     *
+     * @param tree
+     */
+    void SetPursuitIndex(const TreeDistanceIndex *tree) {
+        _tree = tree;
+    }
+
+    /**
+     * @brief Works out the distance from every cell to the nearest enemy
+     *
+     * @param maze
+     */
+    void BuildDistances(const PackedMaze &maze) {
+        _sources.clear();
+        for (size_t i = 0; i < _enemies.size(); i++) {
+            _sources.push_back(_world.GetCellID(_enemies[i]));
+        }
+        _nearest.Compute(maze, _sources);
+        _nearestMaze = &maze;
+        _nearestStale = false;
+    }
+
+    /**
+     * @brief Moves time forward by the elapsed microseconds and handles only the moves and switches that came due, each one is scheduled again
+     * a period later so an update costs the same however many enemies are waiting
+     *
+     * @param maze
+     * @param elapsed
+     * @param playerCell
+     */
+    void Update(const PackedMaze &maze, int elapsed, int playerCell) {
+        _leftover += elapsed;
+        _due.clear();
+        _events.Advance(_leftover / 1000, _due);
+        _leftover %= 1000;
+
+        // Switches are applied straight away, the moving enemies are gathered and sorted so the same moves come out whatever order they came due in
+        _moved.clear();
+        bool huntersMoving = false;
+        for (size_t e = 0; e < _due.size(); e++) {
+            int i = _due[e] >> 1;
+            if (_due[e] & 1) {
+                _world.SwitchState(i);
+                _events.Schedule(_due[e], _switchPeriod[i]);
+            } else {
+                _moved.push_back(i);
+                huntersMoving |= (_type[i] == HUNTER);
+            }
+        }
+        bool detailLevels = _detailDistance != FlowField::UNREACHABLE;
+        bool playerMoved = playerCell != _pursuitTarget;
+        _pursuitTarget = playerCell;
+        bool wake = detailLevels && playerMoved && !_slowedEnemies.empty();
+        if (_moved.empty() && !wake) {
+            return;
+        }
+        sort(_moved.begin(), _moved.end());
+        if (_tree == NULL && (huntersMoving || detailLevels) && _pursuit.Target() != playerCell) {
+            _pursuit.Compute(maze, playerCell);
+        }
+
+        // Enemies further from the player than the detail distance wait longer before their next move. They are listed so that once the
+        // player changes cell the ones now close are brought back to full speed straight away instead of on their next slowed move
+        int moveCount = _moved.size();
+        for (int k = 0; k < moveCount; k++) {
+            int i = _moved[k];
+            bool far = detailLevels && pursuitDistance(_world.GetCellID(i)) > _detailDistance;
+            _events.Schedule(2 * i, far ? _movePeriod[i] * _detailSlowdown : _movePeriod[i]);
+            if (far && _slowed[i] == 0) {
+                _slowedEnemies.push_back(i);
+            }
+            _slowed[i] = far ? 1 : (_slowed[i] == 0 ? 0 : 2);
+        }
+        if (wake) {
+            wakeNearbyEnemies();
+        }
+        if (_moved.empty()) {
+            return;
+        }
+
+        // Every moving enemy picks its target on its own, split into whole batches across the pool when there are enough of them
+        int batchCount = (moveCount + MOVEBATCH - 1) / MOVEBATCH;
+        _targets.resize(batchCount);
+        if (_pool == NULL || _pool->ThreadCount() == 1 || moveCount < PARALLELMOVES) {
+            pickTargets(maze, playerCell, 0, batchCount);
+        } else {
+            int threads = _pool->ThreadCount();
+            _pool->Run([&](int worker) { pickTargets(maze, playerCell, batchCount * worker / threads, batchCount * (worker + 1) / threads); });
+        }
+
+        // Enemies that picked the same cell are settled in entity order, the first one gets the cell and the rest stay where they are
+        _updates++;
+        if (_claimed.size() < (size_t)maze.CellCount()) {
+            _claimed.resize(maze.CellCount(), 0);
+        }
+        _movedFrom.resize(moveCount);
+        for (int k = 0; k < moveCount; k++) {
+            int i = _moved[k];
+            int target = _targets[k / MOVEBATCH].target[k % MOVEBATCH];
+            _movedFrom[k] = _world.GetCellID(i);
+            if (target != _movedFrom[k]) {
+                if (_claimed[target] == _updates) {
+                    continue;
+                }
+                _claimed[target] = _updates;
+                _world.SetCellID(i, target);
+            }
+        }
+
+        // A few moves are patched into the field, past that one fresh search is cheaper than repairing around every enemy and it waits until
+        // the field is next asked for, so frames nobody looks at it in don't pay for it
+        if (_nearestStale || _moved.size() > INCREMENTALMOVES) {
+            _nearestStale = true;
+            return;
+        }
+        for (size_t i = 0; i < _moved.size(); i++) {
+            _nearest.MoveSource(maze, _movedFrom[i], _world.GetCellID(_moved[i]));
+        }
+    }
+
+    /**
+     * @brief Checks whether a red enemy shares the player's cell, only the entities in that cell are looked at
+     *
+     * @param playerCell
+     * @return true
+     * @return false
+     */
+    bool CatchesPlayer(int playerCell) const {
+        for (int entity = _world.FirstInCell(playerCell); entity != -1; entity = _world.NextInCell(entity)) {
+            if (_world.Team(entity) == EntityWorld::ENEMYTEAM && HasPlayerLost(playerCell, _world.GetCellID(entity), !_world.IsAttacking(entity))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns the number of enemies
+     *
+     * @return int
+     */
+    int Count() const { return _enemies.size(); }
+
+    /**
+     * @brief Returns the number of enemies that were due to move in the last update
+     *
+     * @return int
+     */
+    int MovesLastUpdate() const { return _moved.size(); }
+
+    /**
+     * @brief Returns the distance from a cell to the nearest enemy, searching the field again first if it went stale
+     *
+     * @param index
+     * @return uint32_t
+     */
+    uint32_t DistanceToNearest(int index) {
+        if (_nearestStale) {
+            BuildDistances(*_nearestMaze);
+        }
+        return _nearest.Distance(index);
+    }
+};
+
+////////////////ENEMY SETTINGS AND FUNCTIONS///////////////////////////////////
+
+////////////////RENDER SETTINGS AND FUNCTIONS///////////////////////////////////
+
+/**
+ * @brief The whole maze as one batch of quads so it draws in a single call. Only the start and end cells and the walls that are still closed
+ * get quads, path cells are the same colour as the cleared window and open walls are simply left out. Quads are laid out cell by cell in
+ * row order, so the quads of any run of cells in a row sit next to each other
+ *
+ */
+class MazeMesh : public Drawable {
+   private:
+    VertexArray _vertices;         // Quads of the start and end cells and of every closed wall
+    vector<int> _cellStart;        // First vertex of each cell's quads, with one more entry holding the total
+    VertexBuffer _buffer;          // Copy of the quads in video memory, drawn instead of the array when it could be uploaded
+    bool _uploaded;                // True when the buffer holds the current quads
+    const PackedMaze *_builtFrom;  // Maze the quads were last built from
+    uint32_t _builtRevision;       // Revision of that maze when the quads were built
+    int _width;                    // Number of cells in a row of that maze
+    int _height;                   // Number of rows of that maze
+
+    /**
+     * @brief Appends one axis aligned quad
+     *
+     * @param left
+     * @param top
+     * @param width
+     * @param height
+     * @param color
+     */
+    void addQuad(float left, float top, float width, float height, Color color) {
+        _vertices.append(Vertex(Vector2f(left, top), color));
+        _vertices.append(Vertex(Vector2f(left + width, top), color));
+        _vertices.append(Vertex(Vector2f(left + width, top + height), color));
+        _vertices.append(Vertex(Vector2f(left, top + height), color));
+    }
+
+    /**
+     * @brief Copies the quads into the vertex buffer once, the maze stays the same for a whole round so the buffer is marked static and
+     * frames only have to point the GPU at it. Falls back to the array when the driver has no vertex buffer support
+     *
+     */
+    void upload() {
+        _uploaded = false;
+        if (!VertexBuffer::isAvailable()) {
+            return;
+        }
+        if (_buffer.getVertexCount() != _vertices.getVertexCount() && !_buffer.create(_vertices.getVertexCount())) {
+            return;
+        }
+        _uploaded = _vertices.getVertexCount() == 0 || _buffer.update(&_vertices[0]);
+    }
+
+    /**
+     * @brief Draws a run of vertices, from video memory when the buffer is uploaded
+     *
+     * @param target
+     * @param first
+     * @param count
+     * @param states
+     */
+    void drawRange(RenderTarget &target, int first, int count, const RenderStates &states) const {
+        if (count == 0) {
+            return;
+        }
+        if (_uploaded) {
+            target.draw(_buffer, first, count, states);
+        } else {
+            target.draw(&_vertices[first], count, Quads, states);
+        }
+    }
+
+    /**
+     * @brief Draws only the quads of the cells the target's view can see. The quads of a row of cells are stored together so every visible
+     * row is one call, and when the view is as wide as the maze the rows run together into a single call
+     *
+     * @param target
+     * @param states
+     */
+    void draw(RenderTarget &target, RenderStates states) const override {
+        if (_cellStart.empty()) {
+            return;
+        }
+        IntRect cells = returnVisibleCells(target.getView(), _width, _height);
+        if (cells.width == _width) {
+            drawRange(target, _cellStart[cells.top * _width], _cellStart[(cells.top + cells.height) * _width] - _cellStart[cells.top * _width], states);
+            return;
+        }
+        for (int y = cells.top; y < cells.top + cells.height; y++) {
+            int first = _cellStart[y * _width + cells.left];
+            drawRange(target, first, _cellStart[y * _width + cells.left + cells.width] - first, states);
+        }
+    }
+
+   public:
+    /**
+     * @brief Construct a new MazeMesh object with no quads
+     *
+     */
+    MazeMesh() : _vertices(Quads), _buffer(Quads, VertexBuffer::Static), _uploaded(false), _builtFrom(NULL), _builtRevision(0), _width(0), _height(0) {
+    }
+
+    /**
+     * @brief Builds the quads for a maze, cells are laid out and sized the same way as the cells of the grid so the mesh lines up with the
+     * entities. The first cell is the start and the last one the end
+     *
+     * @param maze
+     */
+    void Build(const PackedMaze &maze) {
+        const float size = CELLSIZE - 3;
+        _vertices.clear();
+        _cellStart.resize(maze.CellCount() + 1);
+        for (int i = 0; i < maze.CellCount(); i++) {
+            _cellStart[i] = _vertices.getVertexCount();
+            float x = (i % maze.Width()) * CELLSIZE;
+            float y = (i / maze.Width()) * CELLSIZE;
+            if (i == 0) {
+                addQuad(x, y, size, size, Color::Red);
+            } else if (i == maze.CellCount() - 1) {
+                addQuad(x, y, size, size, Color::Green);
+            }
+            int closed = ~maze.OpenMask(i);
+            if (closed & 1) {
+                addQuad(x, y - 2, size, 2, Color::Blue);
+            }
+            if (closed & 2) {
+                addQuad(x + size, y, 2, size, Color::Blue);
+            }
+            if (closed & 4) {
+                addQuad(x, y + size + 2, size, 2, Color::Blue);
+            }
+            if (closed & 8) {
+                addQuad(x - 4, y, 2, size, Color::Blue);
+            }
+        }
+        _cellStart[maze.CellCount()] = _vertices.getVertexCount();
+        _builtFrom = &maze;
+        _builtRevision = maze.Revision();
+        _width = maze.Width();
+        _height = maze.Height();
+        upload();
+    }
+
+    /**
+     * @brief Rebuilds the mesh only when it was built from another maze or a wall has been opened or closed since
+     *
+     * @param maze
+     * @return true
+     * @return false
+     */
+    bool Update(const PackedMaze &maze) {
+        if (_builtFrom == &maze && _builtRevision == maze.Revision()) {
+            return false;
+        }
+        Build(maze);
+        return true;
+    }
+
+    /**
+     * @brief Draws every quad of the mesh whatever the view can see, only used to measure what culling saves
+     *
+     * @param target
+     */
+    void DrawAll(RenderTarget &target) const {
+        if (!_cellStart.empty()) {
+            drawRange(target, 0, _cellStart.back(), RenderStates::Default);
+        }
+    }
+
+    /**
+     * @brief Checks whether the quads are drawn from video memory
+     *
+     * @return true
+     * @return false
+     */
+    bool IsUploaded() const { return _uploaded; }
+
+    /**
+     * @brief Returns the number of quads in the mesh
+     *
+     * @return int
+     */
+    int QuadCount() const { return _vertices.getVertexCount() / 4; }
+};
+
+/**
+ * @brief Texture holding every tile the game screen is drawn with. Rows 0 to 2 hold a tile for each 4 bit open wall mask on a path, start and
+ * end cell, bit 0 - Top | 1 - Right | 2 - Bottom | 3 - Left, and row 3 holds the entity tiles. The hunter tile is Resources/Texture.png, the
+ * rest are painted when the atlas is built
+ *
+ */
+class TileAtlas {
+   private:
+    Texture _texture;  // Atlas of 16 tiles per row
+
+    /**
+     * @brief Checks whether a point of a tile, with both coordinates from -1 to 1 around the tile's center, is inside the shape of a tile
+     *
+     * @param tile
+     * @param x
+     * @param y
+     * @return true
+     * @return false
+     */
+    static bool insideShape(int tile, float x, float y) {
+        switch (tile) {
+            case ROUNDTILE:
+                return x * x + y * y <= 1;
+            case DIAMONDTILE:
+                return fabs(x) + fabs(y) <= 1;
+            case HUNTERTILE:
+            case PASSIVEHUNTERTILE:
+                return fabs(x) <= (y + 1) / 2;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Paints a cell tile, the closed sides of the mask get a wall along the edge of the tile
+     *
+     * @param atlas
+     * @param tile
+     * @param background
+     * @param openMask
+     */
+    static void paintWallTile(Image &atlas, int tile, Color background, int openMask) {
+        Vector2u corner = TileCorner(tile);
+        for (unsigned y = 0; y < TILESIZE; y++) {
+            for (unsigned x = 0; x < TILESIZE; x++) {
+                bool wall = (!(openMask & 1) && y < WALLTHICKNESS) || (!(openMask & 2) && x >= TILESIZE - WALLTHICKNESS) ||
+                            (!(openMask & 4) && y >= TILESIZE - WALLTHICKNESS) || (!(openMask & 8) && x < WALLTHICKNESS);
+                atlas.setPixel(corner.x + x, corner.y + y, wall ? Color::Blue : background);
+            }
+        }
+    }
+
+    /**
+     * @brief Paints an entity tile as a solid shape on a transparent background
+     *
+     * @param atlas
+     * @param tile
+     * @param color
+     */
+    static void paintShapeTile(Image &atlas, int tile, Color color) {
+        Vector2u corner = TileCorner(tile);
+        for (unsigned y = 0; y < TILESIZE; y++) {
+            for (unsigned x = 0; x < TILESIZE; x++) {
+                float u = (x + 0.5f) / TILESIZE * 2 - 1;
+                float v = (y + 0.5f) / TILESIZE * 2 - 1;
+                atlas.setPixel(corner.x + x, corner.y + y, insideShape(tile, u, v) ? color : Color::Transparent);
+            }
+        }
+    }
+
+   public:
+    /**
+     * @brief Tiles of the atlas
+     *
+     */
+    enum TILES : uint32_t {
+        PATHTILES = 0,
+        STARTTILES = 16,
+        ENDTILES = 32,
+        ROUNDTILE = 48,
+        DIAMONDTILE,
+        HUNTERTILE,
+        PASSIVEHUNTERTILE
+    };
+
+    enum : uint32_t {
+        TILESIZE = 32,     // Width and height of a tile in texels, the size of Resources/Texture.png
+        WALLTHICKNESS = 1  // Texels of wall along a closed side, neighbouring tiles both draw the wall they share
+    };
+
+    /**
+     * @brief Returns the top left texel of a tile
+     *
+     * @param tile
+     * @return Vector2u
+     */
+    static Vector2u TileCorner(int tile) { return Vector2u((tile % 16) * TILESIZE, (tile / 16) * TILESIZE); }
+
+    /**
+     * @brief Paints the tiles and uploads the atlas, returns false when the texture could not be made. A missing or differently sized
+     * Resources/Texture.png is replaced by a painted triangle
+     *
+     * @return true
+     * @return false
+     */
+    bool Build() {
+        Image atlas;
+        atlas.create(16 * TILESIZE, 4 * TILESIZE, Color::Transparent);
+        for (int openMask = 0; openMask < 16; openMask++) {
+            paintWallTile(atlas, PATHTILES + openMask, Color::Black, openMask);
+            paintWallTile(atlas, STARTTILES + openMask, Color::Red, openMask);
+            paintWallTile(atlas, ENDTILES + openMask, Color::Green, openMask);
+        }
+        // Round and diamond tiles are white so quads can tint them, hunters keep the colours of their texture
+        paintShapeTile(atlas, ROUNDTILE, Color::White);
+        paintShapeTile(atlas, DIAMONDTILE, Color::White);
+
+        Image hunter;
+        if (hunter.loadFromFile("Projects/Resources/Texture.png") && hunter.getSize() == Vector2u(TILESIZE, TILESIZE)) {
+            // The passive hunter is the same picture with red and green swapped
+            Vector2u attacking = TileCorner(HUNTERTILE);
+            Vector2u passive = TileCorner(PASSIVEHUNTERTILE);
+            for (unsigned y = 0; y < TILESIZE; y++) {
+                for (unsigned x = 0; x < TILESIZE; x++) {
+                    Color texel = hunter.getPixel(x, y);
+                    atlas.setPixel(attacking.x + x, attacking.y + y, texel);
+                    atlas.setPixel(passive.x + x, passive.y + y, Color(texel.g, texel.r, texel.b, texel.a));
+                }
+            }
+        } else {
+            cout << "Failed to load texture file" << endl;
+            paintShapeTile(atlas, HUNTERTILE, Color::Red);
+            paintShapeTile(atlas, PASSIVEHUNTERTILE, Color::Green);
+        }
+        return _texture.loadFromImage(atlas);
+    }
+
+    /**
+     * @brief Returns the atlas texture
+     *
+     * @return const Texture&
+     */
+    const Texture &GetTexture() const { return _texture; }
+
+    /**
+     * @brief Appends a quad showing a tile, tinted by a colour
+     *
+     * @param vertices
+     * @param tile
+     * @param position
+     * @param size
+     * @param tint
+     */
+    static void AppendTile(VertexArray &vertices, int tile, Vector2f position, float size, Color tint) {
+        Vector2f corner(TileCorner(tile));
+        vertices.append(Vertex(position, tint, corner));
+        vertices.append(Vertex(position + Vector2f(size, 0), tint, corner + Vector2f(TILESIZE, 0)));
+        vertices.append(Vertex(position + Vector2f(size, size), tint, corner + Vector2f(TILESIZE, TILESIZE)));
+        vertices.append(Vertex(position + Vector2f(0, size), tint, corner + Vector2f(0, TILESIZE)));
+    }
+};
+
+/**
+ * @brief Maze drawn as one textured quad per cell, each cell shows the atlas tile of its open wall mask so the whole maze is a single draw
+ *
+ */
+class TileMap : public Drawable {
+   private:
+    VertexArray _vertices;         // Quad of cell i in vertices 4i to 4i + 3
+    const Texture *_texture;       // Atlas the tiles are cut from
+    const PackedMaze *_builtFrom;  // Maze the quads were last built from
+    uint32_t _builtRevision;       // Revision of that maze when the quads were built
+    int _width;                    // Number of cells in a row of that maze
+    int _height;                   // Number of rows of that maze
+
+    /**
+     * @brief Draws the tiles of the cells the target's view can see, one call per visible row or a single call when the view is as wide
+     * as the maze
+     *
+     * @param target
+     * @param states
+     */
+    void draw(RenderTarget &target, RenderStates states) const override {
+        if (_vertices.getVertexCount() == 0) {
+            return;
+        }
+        states.texture = _texture;
+        IntRect cells = returnVisibleCells(target.getView(), _width, _height);
+        if (cells.width == _width && cells.height > 0) {
+            target.draw(&_vertices[4 * cells.top * _width], 4 * cells.height * _width, Quads, states);
+            return;
+        }
+        for (int y = cells.top; y < cells.top + cells.height; y++) {
+            target.draw(&_vertices[4 * (y * _width + cells.left)], 4 * cells.width, Quads, states);
+        }
+    }
+
+   public:
+    /**
+     * @brief Construct a new TileMap object with no tiles
+     *
+     */
+    TileMap() : _vertices(Quads), _texture(NULL), _builtFrom(NULL), _builtRevision(0), _width(0), _height(0) {
+    }
+
+    /**
+     * @brief Builds a tile for every cell of a maze, the first cell is the start and the last one the end
+     *
+     * @param maze
+     * @param atlas
+     */
+    void Build(const PackedMaze &maze, const TileAtlas &atlas) {
+        _vertices.clear();
+        for (int i = 0; i < maze.CellCount(); i++) {
+            int background = (i == 0) ? TileAtlas::STARTTILES : ((i == maze.CellCount() - 1) ? TileAtlas::ENDTILES : TileAtlas::PATHTILES);
+            Vector2f corner((i % maze.Width()) * CELLSIZE, (i / maze.Width()) * CELLSIZE);
+            TileAtlas::AppendTile(_vertices, background + maze.OpenMask(i), corner, CELLSIZE, Color::White);
+        }
+        _texture = &atlas.GetTexture();
+        _builtFrom = &maze;
+        _builtRevision = maze.Revision();
+        _width = maze.Width();
+        _height = maze.Height();
+    }
+
+    /**
+     * @brief Rebuilds the tiles only when they were built from another maze or a wall has been opened or closed since
+     *
+     * @param maze
+     * @param atlas
+     * @return true
+     * @return false
+     */
+    bool Update(const PackedMaze &maze, const TileAtlas &atlas) {
+        if (_builtFrom == &maze && _builtRevision == maze.Revision()) {
+            return false;
+        }
+        Build(maze, atlas);
+        return true;
+    }
+};
+
+/**
+ * @brief Maze drawn once into an off screen texture so a frame only has to draw one sprite for the whole background. Mazes too large for a
+ * texture on the current GPU keep drawing the mesh instead
+ *
+ */
+class MazeBackground : public Drawable {
+   private:
+    MazeMesh _mesh;           // Geometry rendered into the texture, and drawn directly when there is no texture
+    TileMap _tiles;           // Textured tiles used instead of the geometry when there is an atlas
+    const TileAtlas *_atlas;  // Atlas of the tiles, NULL to draw the flat coloured geometry
+    RenderTexture _canvas;    // Off screen target holding the rendered maze
+    Sprite _sprite;           // Draws the texture at the origin of the maze
+    bool _cached;             // True when the texture holds the current maze
+
+    /**
+     * @brief Returns what the maze is drawn with, the tiles when there is an atlas and the geometry otherwise
+     *
+     * @return const Drawable&
+     */
+    const Drawable &source() const {
+        if (_atlas) {
+            return _tiles;
+        }
+        return _mesh;
+    }
+
+    /**
+     * @brief Renders the mesh into the texture, resizing the texture only when the maze size changed
+     *
+     * @param maze
+     */
+    void render(const PackedMaze &maze) {
+        unsigned width = maze.Width() * CELLSIZE;
+        unsigned height = maze.Height() * CELLSIZE;
+        _cached = false;
+        if (width > Texture::getMaximumSize() || height > Texture::getMaximumSize()) {
+            return;
+        }
+        Vector2u size = _canvas.getSize();
+        if ((size.x != width || size.y != height) && !_canvas.create(width, height)) {
+            return;
+        }
+        _canvas.clear();
+        _canvas.draw(source());
+        _canvas.display();
+        _sprite.setTexture(_canvas.getTexture(), true);
+        _cached = true;
+    }
+
+    /**
+     * @brief Draws the cached sprite, or the tiles or mesh when the maze could not be cached
+     *
+     * @param target
+     * @param states
+     */
+    void draw(RenderTarget &target, RenderStates states) const override {
+        if (_cached) {
+            target.draw(_sprite, states);
+        } else {
+            target.draw(source(), states);
+        }
+    }
+
+   public:
+    /**
+     * @brief Construct a new MazeBackground object with nothing cached
+     *
+     */
+    MazeBackground() : _atlas(NULL), _cached(false) {
+    }
+
+    /**
+     * @brief Draws the maze from the tiles of an atlas from the next build on, NULL goes back to the flat coloured geometry
+     *
+     * @param atlas
+     */
+    void SetAtlas(const TileAtlas *atlas) { _atlas = atlas; }
+
+    /**
+     * @brief Builds the mesh, and the tiles when there is an atlas, of a maze and renders it into the texture
+     *
+     * @param maze
+     */
+    void Build(const PackedMaze &maze) {
+        _mesh.Build(maze);
+        if (_atlas) {
+            _tiles.Build(maze, *_atlas);
+        }
+        render(maze);
+    }
+
+    /**
+     * @brief Renders the maze again only when a wall has been opened or closed since the last build
+     *
+     * @param maze
+     * @return true
+     * @return false
+     */
+    bool Update(const PackedMaze &maze) {
+        if (!_mesh.Update(maze)) {
+            return false;
+        }
+        if (_atlas) {
+            _tiles.Build(maze, *_atlas);
+        }
+        render(maze);
+        return true;
+    }
+
+    /**
+     * @brief Checks whether the background is drawn as a single sprite
+     *
+     * @return true
+     * @return false
+     */
+    bool IsCached() const { return _cached; }
+};
+
+/**
+ * @brief Retained picture of the game screen kept in an off screen texture. A frame either draws the whole picture again, when the camera
+ * moved or something covering the whole screen changed, or only patches the cells that changed, and frames where nothing changed leave the
+ * window as it is. When no texture can be made every frame is drawn in full straight to the window
+ *
+ */
+class SceneCanvas {
+   private:
+    RenderTexture _canvas;  // Retained picture of the screen
+    Sprite _sprite;         // Copies the picture to the window
+    View _view;             // Camera the picture was drawn with
+    bool _created;          // True when the texture could be made
+    bool _valid;            // False until the first full redraw and after Invalidate
+    RenderTarget *_target;  // Where the current frame is drawn, the texture or the window
+
+   public:
+    /**
+     * @brief Construct a new SceneCanvas object the size of a window
+     *
+     * @param window
+     */
+    SceneCanvas(const RenderWindow &window) : _valid(false), _target(NULL) {
+        _created = _canvas.create(window.getSize().x, window.getSize().y);
+        if (_created) {
+            _sprite.setTexture(_canvas.getTexture(), true);
+        }
+    }
+
+    /**
+     * @brief Makes the next frame draw the whole picture again
+     *
+     */
+    void Invalidate() { _valid = false; }
+
+    /**
+     * @brief Starts a frame seen through a camera and returns true when the whole picture has to be drawn again, in which case it has been
+     * cleared. Otherwise only the parts that changed need to be drawn over
+     *
+     * @param window
+     * @param view
+     * @return true
+     * @return false
+     */
+    bool Begin(RenderWindow &window, const View &view) {
+        bool moved = view.getCenter() != _view.getCenter() || view.getSize() != _view.getSize();
+        _view = view;
+        _target = _created ? (RenderTarget *)&_canvas : (RenderTarget *)&window;
+        _target->setView(view);
+        if (_created && _valid && !moved) {
+            return false;
+        }
+        _target->clear();
+        _valid = true;
+        return true;
+    }
+
+    /**
+     * @brief Returns the target the current frame is drawn to
+     *
+     * @return RenderTarget&
+     */
+    RenderTarget &Target() { return *_target; }
+
+    /**
+     * @brief Shows the picture in the window
+     *
+     * @param window
+     */
+    void Present(RenderWindow &window) {
+        if (_created) {
+            _canvas.display();
+            window.setView(window.getDefaultView());
+            window.draw(_sprite);
+        }
+        window.display();
+    }
+};
+
+/**
+ * @brief Draws the entities with tiles from the atlas, the quads of every entity on screen are gathered into one array and drawn in a single
+ * call. Hunters use the hunter tiles, wanderers the diamond tile and the player the round tile tinted by team and state
+ *
+ */
+class EntityTiles : public Drawable {
+   private:
+    const EntityWorld &_world;      // Entities to draw
+    const TileAtlas &_atlas;        // Atlas holding the entity tiles
+    mutable VertexArray _vertices;  // Quads of the entities drawn by the last call, reused between frames
+    mutable int _drawn;             // Entities drawn by the last draw
+
+    /**
+     * @brief Appends a quad for every entity standing in a cell
+     *
+     * @param cell
+     */
+    void appendCell(int cell) const {
+        for (int entity = _world.FirstInCell(cell); entity != -1; entity = _world.NextInCell(entity)) {
+            int tile = TileAtlas::ROUNDTILE;
+            Color tint = Color::White;
+            if (_world.Team(entity) == EntityWorld::PLAYERTEAM) {
+                tint = Color::Yellow;
+            } else if (_world.Points(entity) == 3) {
+                tile = _world.IsAttacking(entity) ? TileAtlas::HUNTERTILE : TileAtlas::PASSIVEHUNTERTILE;
+            } else {
+                tile = (_world.Points(entity) == 4) ? TileAtlas::DIAMONDTILE : TileAtlas::ROUNDTILE;
+                tint = _world.IsAttacking(entity) ? Color::Red : Color::Green;
+            }
+            TileAtlas::AppendTile(_vertices, tile, _world.Transform(entity) - Vector2f(CELLSIZE / 4, CELLSIZE / 4), CELLSIZE / 2, tint);
+            _drawn++;
+        }
+    }
+
+    /**
+     * @brief Draws the entities in the cells the target's view can see
+     *
+     * @param target
+     * @param states
+     */
+    void draw(RenderTarget &target, RenderStates states) const override {
+        IntRect cells = returnVisibleCells(target.getView(), CELLCOUNT, CELLCOUNT);
+        _vertices.clear();
+        _drawn = 0;
+        for (int y = cells.top; y < cells.top + cells.height; y++) {
+            for (int x = cells.left; x < cells.left + cells.width; x++) {
+                appendCell(returnArrayIndex(x, y));
             }
         }
-        if (Coordinates.x + 1 < CELLCOUNT) {
-            if (grid[Coordinates.x + 1].GetCellState() == 0) {
-                neighbours.y = true;
-            }
+        if (_drawn > 0) {
+            states.texture = &_atlas.GetTexture();
+            target.draw(_vertices, states);
         }
-        return neighbours;
     }
 
+   public:
     /**
-     * @brief Returns the renderable body of a cell given its index
+     * @brief Construct a new EntityTiles object
      *
-     * @param Index
-     * @return RectangleShape
+     * @param world
+     * @param atlas
      */
-    RectangleShape ReturnCell(int Index) {
-        return grid[Index].CELL();
+    EntityTiles(const EntityWorld &world, const TileAtlas &atlas) : _world(world), _atlas(atlas), _vertices(Quads), _drawn(0) {
     }
 
     /**
-     * @brief Returns the renderable body of a cells walls given its index
+     * @brief Draws the entities standing in one cell in a single call and returns the number of calls made
      *
-     * @param cellIndex
-     * @param wallIndex
-     * @return RectangleShape
+     * @param target
+     * @param cell
+     * @return int
      */
-    RectangleShape ReturnWall(int cellIndex, int wallIndex) {
-        return grid[cellIndex].WALL(wallIndex);
+    int DrawCell(RenderTarget &target, int cell) const {
+        _vertices.clear();
+        _drawn = 0;
+        appendCell(cell);
+        if (_drawn == 0) {
+            return 0;
+        }
+        target.draw(_vertices, RenderStates(&_atlas.GetTexture()));
+        return 1;
     }
+
+    /**
+     * @brief Returns the number of draw calls made by the last draw
+     *
+     * @return int
+     */
+    int DrawCalls() const { return (_drawn > 0) ? 1 : 0; }
 };
 
-////////////////GRID SETTINGS AND FUNCTIONS///////////////////////////////////
+////////////////RENDER SETTINGS AND FUNCTIONS///////////////////////////////////
 
 ////////////////GUI SETTINGS AND FUNCTIONS///////////////////////////////////
 
@@ -992,7 +4466,7 @@ class Grid {
  * @brief UI text object
  *
  */
-class UIText {
+class UIText : public Drawable {
    private:
     Text _textObj;       // Renderable text
     string _text;        // Holds the string or sentence that is to be rendered
@@ -1015,6 +4489,16 @@ class UIText {
         _textObj.setOrigin(_textObj.getLocalBounds().left + _textObj.getLocalBounds().width / 2, _textObj.getLocalBounds().top + _textObj.getLocalBounds().height / 2);
     }
 
+    /**
+     * @brief Draws the text object in place
+     *
+     * @param target
+     * @param states
+     */
+    void draw(RenderTarget &target, RenderStates states) const override {
+        target.draw(_textObj, states);
+    }
+
    public:
     /**
      * @brief Construct a new UIText object
@@ -1034,24 +4518,18 @@ class UIText {
         if (!_font.loadFromFile("Projects/Resources/Fonts/PlayfairDisplay-Bold.ttf")) {
             cout << "Failed to open font file" << endl;
         }
-    }
-
-    /**
-     * @brief Returns the renderable text object
-     *
-     * @return Text
-     */
-    Text returnText() {
         UpdateText();
-        return _textObj;
     }
+
+    UIText(const UIText &) = delete;
+    UIText &operator=(const UIText &) = delete;
 };
 
 /**
  * @brief Class UIButton
  *
  */
-class UIButton {
+class UIButton : public Drawable {
    private:
     RectangleShape _button;  // Holds the renderable button object
     Text _buttonText;        // Holds the text of the button
@@ -1066,6 +4544,17 @@ class UIButton {
         return Vector2f(_button.getGlobalBounds().left + _button.getGlobalBounds().width / 2, _button.getGlobalBounds().top + _button.getGlobalBounds().height / 2);
     }
 
+    /**
+     * @brief Draws the button with its text on top
+     *
+     * @param target
+     * @param states
+     */
+    void draw(RenderTarget &target, RenderStates states) const override {
+        target.draw(_button, states);
+        target.draw(_buttonText, states);
+    }
+
    public:
     /**
      * @brief Construct a new UIButton object
@@ -1095,6 +4584,9 @@ class UIButton {
         _buttonText.setOrigin(_buttonText.getLocalBounds().left + _buttonText.getLocalBounds().width / 2, _buttonText.getLocalBounds().top + _buttonText.getLocalBounds().height / 2);
     }
 
+    UIButton(const UIButton &) = delete;
+    UIButton &operator=(const UIButton &) = delete;
+
     /**
      * @brief Set the Outline Color object
      *
@@ -1124,24 +4616,6 @@ class UIButton {
     bool IsAt(float x, float y) {
         return _button.getGlobalBounds().contains(x, y);
     }
-
-    /**
-     * @brief Get the Button object
-     *
-     * @return RectangleShape
-     */
-    RectangleShape GetButton() {
-        return _button;
-    }
-
-    /**
-     * @brief Get the Button Text object
-     *
-     * @return Text
-     */
-    Text GetButtonText() {
-        return _buttonText;
-    }
 };
 
 ////////////////GUI SETTINGS AND FUNCTIONS///////////////////////////////////
@@ -1171,7 +4645,7 @@ int RenderUIWindow() {
 
     UIText title(299, 100, 85, "Maze Game", Color::White);
     UIText author(500, 785, 20, "By: Tharin Sandipa", Color::White);
-    UIText tutorial(299, 350, 20, "How to Play: \n\n>Use the arrow keys to \nnavigate the maze and avoid enemies\n(hint enemies state changes every 2 seconds\n and you can pass through them when they are green).\n\n>Press Q or the Escape key at anytime \nto quit out of the game\n\n>The goal of the game is to go\n from the red block to the green block", Color::White);
+    UIText tutorial(299, 350, 20, "How to Play: \n\n>Use the arrow keys to \nnavigate the maze and avoid enemies\n(hint enemies state changes every 2 seconds\n and you can pass through them when they are green).\n\n>Press H to show a hint or S to show the solution\n\n>Press Q or the Escape key at anytime \nto quit out of the game\n\n>The goal of the game is to go\n from the red block to the green block", Color::White);
 
     UIButton menuButton(299, 600, 70, 200, Color::Black, "Play Game");
 
@@ -1209,11 +4683,10 @@ int RenderUIWindow() {
 
         menuWindow.clear();
         menuWindow.draw(BackGround);
-        menuWindow.draw(title.returnText());
-        menuWindow.draw(author.returnText());
-        menuWindow.draw(tutorial.returnText());
-        menuWindow.draw(menuButton.GetButton());
-        menuWindow.draw(menuButton.GetButtonText());
+        menuWindow.draw(title);
+        menuWindow.draw(author);
+        menuWindow.draw(tutorial);
+        menuWindow.draw(menuButton);
         menuWindow.display();
     }
     return 3;
@@ -1238,41 +4711,116 @@ int RenderGameWindow() {
     // Grid
     Grid Maze;
 
-    // Entities
-    Player playerCharacter(Maze.grid[0].ReturnCenter().x, Maze.grid[0].ReturnCenter().y, 0, Color::Yellow);
-
-    vector<Enemy> enemyCharacters;
-    for (int i = 0; i < 4; i++) {
-        int randomID = 32 + rand() % ((CELLCOUNT * CELLCOUNT) - 32);
-        if (randomID <= 10 || randomID == ((CELLCOUNT * CELLCOUNT) - 1)) {
-            randomID = 32 + rand() % ((CELLCOUNT * CELLCOUNT) - 32);
+    // Entities, the player is created first and the enemy system adds the enemies to the same world
+    EntityWorld world;
+    int player = world.Create(0, EntityWorld::PLAYERTEAM, 10);
+
+    // Enemies, the distance from every cell to the nearest one is kept up to date as they move and the hunters chase the player through the
+    // maze's distance index
+    EnemySystem enemies(world, rand());
+    enemies.SetPursuitIndex(&Maze.GetCellDistances());
+
+    // Enemies spawn on different cells at least SPAWNDISTANCE steps from the player and never on the end cell
+    DistanceField playerDistances;
+    playerDistances.Compute(Maze.GetWalls(), world.GetCellID(player));
+    SpawnSampler spawns(rand());
+    spawns.Build(playerDistances, CELLCOUNT * CELLCOUNT, SPAWNDISTANCE);
+    spawns.Exclude((CELLCOUNT * CELLCOUNT) - 1);
+    for (int i = 0; i < ENEMYCOUNT && spawns.Remaining() > 0; i++) {
+        enemies.Spawn(spawns.Take(), (i < HUNTERCOUNT) ? EnemySystem::HUNTER : EnemySystem::WANDERER);
+    }
+    enemies.BuildDistances(Maze.GetWalls());
+
+    // Tiles the maze and entities are drawn with, the flat coloured shapes are kept for when the atlas can't be made
+    TileAtlas atlas;
+    bool tiled = atlas.Build();
+    EntityTiles entityTiles(world, atlas);
+
+    // Maze and its start and end markers rendered once into a texture, only rendered again when a wall changes
+    MazeBackground background;
+    background.SetAtlas(tiled ? &atlas : NULL);
+    background.Build(Maze.GetWalls());
+
+    // Solution overlay from dead end filling, toggled with S, batched into one array of quads like the maze. The quads are in row order and
+    // the first vertex of each row is kept so only the rows in view are drawn
+    bool showSolution = false;
+    DeadEndFiller solutionFiller;
+    solutionFiller.Solve(Maze.GetWalls());
+    VertexArray solutionQuads(Quads);
+    vector<int> solutionRowStart(CELLCOUNT + 1, 0);
+    for (int i = 0; i < CELLCOUNT * CELLCOUNT; i++) {
+        if (i % CELLCOUNT == 0) {
+            solutionRowStart[i / CELLCOUNT] = solutionQuads.getVertexCount();
+        }
+        if (solutionFiller.OnSolution(Maze.GetWalls(), i)) {
+            Vector2f corner = Maze.grid[i].CELL().getPosition();
+            solutionQuads.append(Vertex(corner, Color(255, 255, 255, 60)));
+            solutionQuads.append(Vertex(corner + Vector2f(CELLSIZE - 3, 0), Color(255, 255, 255, 60)));
+            solutionQuads.append(Vertex(corner + Vector2f(CELLSIZE - 3, CELLSIZE - 3), Color(255, 255, 255, 60)));
+            solutionQuads.append(Vertex(corner + Vector2f(0, CELLSIZE - 3), Color(255, 255, 255, 60)));
         }
-        enemyCharacters.push_back(Enemy(Maze.grid[randomID].ReturnCenter().x, Maze.grid[randomID].ReturnCenter().x, 4, randomID, Color::Red, true));
     }
+    solutionRowStart[CELLCOUNT] = solutionQuads.getVertexCount();
+
+    // Hint marker showing the next cell towards the end, toggled with H
+    bool showHint = false;
+    CircleShape hintMarker(CELLSIZE / 8);
+    hintMarker.setOrigin(Vector2f(CELLSIZE / 8, CELLSIZE / 8));
+    hintMarker.setFillColor(Color::White);
+
+    // Camera that follows the player, Z zooms in and X zooms out until the whole maze fits
+    const Vector2f mazeSize(CELLCOUNT * CELLSIZE, CELLCOUNT * CELLSIZE);
+    const float maxZoom = max(1.f, mazeSize.x / WINDOWDIMENSIONS);
+    View camera(FloatRect(0, 0, WINDOWDIMENSIONS, WINDOWDIMENSIONS));
+    float zoom = 1;
+
+    // Retained picture of the screen, between full redraws only the inside of cells that changed is patched with cellPatch
+    SceneCanvas scene(mainWindow);
+    vector<int> dirtyCells;
+    RectangleShape cellPatch(Vector2f(CELLSIZE / 2 + 2, CELLSIZE / 2 + 2));
+    cellPatch.setOrigin(cellPatch.getSize() / 2.f);
+    int shownHintCell = -1;
+    Color shownHintColor = Color::White;
 
     Clock timer;
-    Time time = timer.getElapsedTime();
-    Time timeToElaspe = milliseconds(2000);
+    int reportedDrawCalls = -1;
 
     while (mainWindow.isOpen()) {
-        time = timer.getElapsedTime();
         while (mainWindow.pollEvent(gameEvents)) {
             switch (gameEvents.type) {
                 case Event::Closed:
                     mainWindow.close();
                     break;
+                // The window may have lost its contents while it was covered or resized and idle frames don't present, so draw it all again
+                case Event::GainedFocus:
+                case Event::Resized:
+                    scene.Invalidate();
+                    break;
                 case Event::KeyPressed:
                     if (Keyboard::isKeyPressed(Keyboard::Up)) {
-                        playerCharacter.UpdatePosition(Maze.grid[playerCharacter.MoveUp(Maze.GetNeighbours(playerCharacter.GetCellID()))].ReturnCenter());
+                        world.Move(Maze.GetWalls(), player, 0);
                     }
                     if (Keyboard::isKeyPressed(Keyboard::Down)) {
-                        playerCharacter.UpdatePosition(Maze.grid[playerCharacter.MoveDown(Maze.GetNeighbours(playerCharacter.GetCellID()))].ReturnCenter());
+                        world.Move(Maze.GetWalls(), player, 2);
                     }
                     if (Keyboard::isKeyPressed(Keyboard::Left)) {
-                        playerCharacter.UpdatePosition(Maze.grid[playerCharacter.MoveLeft(Maze.GetNeighbours(playerCharacter.GetCellID()))].ReturnCenter());
+                        world.Move(Maze.GetWalls(), player, 3);
                     }
                     if (Keyboard::isKeyPressed(Keyboard::Right)) {
-                        playerCharacter.UpdatePosition(Maze.grid[playerCharacter.MoveRight(Maze.GetNeighbours(playerCharacter.GetCellID()))].ReturnCenter());
+                        world.Move(Maze.GetWalls(), player, 1);
+                    }
+                    if (Keyboard::isKeyPressed(Keyboard::H)) {
+                        showHint = !showHint;
+                    }
+                    if (Keyboard::isKeyPressed(Keyboard::S)) {
+                        showSolution = !showSolution;
+                        scene.Invalidate();
+                    }
+                    if (Keyboard::isKeyPressed(Keyboard::Z)) {
+                        zoom = max(MINZOOM, zoom / 1.25f);
+                    }
+                    if (Keyboard::isKeyPressed(Keyboard::X)) {
+                        zoom = min(maxZoom, zoom * 1.25f);
                     }
                     // Press Q or Esq to exit program
                     if (Keyboard::isKeyPressed(Keyboard::Q) || Keyboard::isKeyPressed(Keyboard::Escape)) {
@@ -1282,37 +4830,104 @@ int RenderGameWindow() {
             }
         }
 
-        // Waits a specified time in milliseconds then moves enemy
-        if (time.asMilliseconds() >= timeToElaspe.asMilliseconds()) {
-            for (int i = 0; i < 4; i++) {
-                enemyCharacters[i].UpdatePosition(Maze.grid[enemyCharacters[i].MoveEnemy(Maze.GetNeighbours(enemyCharacters[i].GetCellID()), playerCharacter.GetCellID(), Maze.GetCellStates(enemyCharacters[i].GetCellID()))].ReturnCenter());
-                enemyCharacters[i].SwitchEntityState();
-            }
-            timer.restart();
-        }
+        // Counts down the enemies' timers by the time the last frame took and moves the ones that are due
+        enemies.Update(Maze.GetWalls(), timer.restart().asMicroseconds(), world.GetCellID(player));
 
-        if (HasPlayerWon(Maze.grid[playerCharacter.GetCellID()].GetCellState())) {
+        if (HasPlayerWon(Maze.grid[world.GetCellID(player)].GetCellState())) {
             return 2;
         }
 
-        for (int i = 0; i < 4; i++) {
-            if (HasPlayerLost(playerCharacter.GetCellID(), enemyCharacters[i].GetCellID(), enemyCharacters[i].GetEntityState())) {
-                return 1;
+        if (enemies.CatchesPlayer(world.GetCellID(player))) {
+            return 1;
+        }
+
+        camera.setSize(WINDOWDIMENSIONS * zoom, WINDOWDIMENSIONS * zoom);
+        camera.setCenter(returnCameraCenter(returnCellCenter(world.GetCellID(player)), camera.getSize(), mazeSize));
+
+        if (background.Update(Maze.GetWalls())) {
+            scene.Invalidate();
+        }
+
+        // The hint turns red when the next step is next to an enemy, the cells it leaves and enters need patching
+        int hintCell = -1;
+        Color hintColor = Color::White;
+        if (showHint) {
+            hintCell = Maze.NextStepToExit(world.GetCellID(player));
+            hintColor = (enemies.DistanceToNearest(hintCell) <= 1) ? Color::Red : Color::White;
+            hintMarker.setFillColor(hintColor);
+            hintMarker.setPosition(Maze.grid[hintCell].ReturnCenter());
+        }
+        world.TakeDirtyCells(dirtyCells);
+        if (hintCell != shownHintCell || hintColor != shownHintColor) {
+            if (shownHintCell != -1) {
+                dirtyCells.push_back(shownHintCell);
             }
+            if (hintCell != -1) {
+                dirtyCells.push_back(hintCell);
+            }
+            shownHintCell = hintCell;
+            shownHintColor = hintColor;
         }
 
-        mainWindow.clear();
-        for (int i = 0; i < CELLCOUNT * CELLCOUNT; i++) {
-            mainWindow.draw(Maze.ReturnCell(i));
-            for (int j = 0; j < 4; j++) {
-                mainWindow.draw(Maze.ReturnWall(i, j));
+        int drawCalls = 0;
+        IntRect visibleCells = returnVisibleCells(camera, CELLCOUNT, CELLCOUNT);
+        if (scene.Begin(mainWindow, camera)) {
+            scene.Target().draw(background);
+            drawCalls++;
+            int solutionStart = solutionRowStart[visibleCells.top];
+            int solutionCount = solutionRowStart[visibleCells.top + visibleCells.height] - solutionStart;
+            if (showSolution && solutionCount > 0) {
+                scene.Target().draw(&solutionQuads[solutionStart], solutionCount, Quads);
+                drawCalls++;
+            }
+            if (hintCell != -1) {
+                scene.Target().draw(hintMarker);
+                drawCalls++;
+            }
+            world.UpdateTransforms(visibleCells);
+            if (tiled) {
+                scene.Target().draw(entityTiles);
+                drawCalls += entityTiles.DrawCalls();
+            } else {
+                scene.Target().draw(world);
+                drawCalls += world.DrawCalls();
+            }
+        } else if (!dirtyCells.empty()) {
+            for (int cell : dirtyCells) {
+                Vector2i coordinates = returnCoordinates(cell);
+                if (!visibleCells.contains(coordinates)) {
+                    continue;
+                }
+                // Restores the inside of the cell, where the entities and the hint are drawn, then draws those again on top
+                cellPatch.setPosition(returnCellCenter(cell));
+                cellPatch.setFillColor((cell == 0) ? Color::Red : ((cell == (CELLCOUNT * CELLCOUNT) - 1) ? Color::Green : Color::Black));
+                scene.Target().draw(cellPatch);
+                drawCalls++;
+                if (showSolution && solutionFiller.OnSolution(Maze.GetWalls(), cell)) {
+                    cellPatch.setFillColor(Color(255, 255, 255, 60));
+                    scene.Target().draw(cellPatch);
+                    drawCalls++;
+                }
+                if (cell == hintCell) {
+                    scene.Target().draw(hintMarker);
+                    drawCalls++;
+                }
+                world.UpdateTransforms(IntRect(coordinates.x, coordinates.y, 1, 1));
+                drawCalls += tiled ? entityTiles.DrawCell(scene.Target(), cell) : world.DrawCell(scene.Target(), cell);
             }
+        } else {
+            // Nothing changed so the window keeps showing the last picture
+            sleep(milliseconds(IDLESLEEP));
+            continue;
         }
-        mainWindow.draw(playerCharacter.ReturnEntity());
-        for (int i = 0; i < 4; i++) {
-            mainWindow.draw(enemyCharacters[i].ReturnEntity());
+        dirtyCells.clear();
+        scene.Present(mainWindow);
+
+        // Reports the draw calls of the last drawn frame in the title whenever the number changes
+        if (drawCalls != reportedDrawCalls) {
+            reportedDrawCalls = drawCalls;
+            mainWindow.setTitle("Maze Game | " + to_string(drawCalls) + " draw calls per frame");
         }
-        mainWindow.display();
     }
     return 3;
 }
@@ -1380,11 +4995,10 @@ int RenderFailEndScreen() {
 
         menuWindow.clear();
         menuWindow.draw(BackGround);
-        menuWindow.draw(title.returnText());
-        menuWindow.draw(author.returnText());
-        menuWindow.draw(tutorial.returnText());
-        menuWindow.draw(menuButton.GetButton());
-        menuWindow.draw(menuButton.GetButtonText());
+        menuWindow.draw(title);
+        menuWindow.draw(author);
+        menuWindow.draw(tutorial);
+        menuWindow.draw(menuButton);
         menuWindow.display();
     }
     return 3;
@@ -1453,22 +5067,797 @@ int RenderWinEndScreen() {
 
         menuWindow.clear();
         menuWindow.draw(BackGround);
-        menuWindow.draw(title.returnText());
-        menuWindow.draw(author.returnText());
-        menuWindow.draw(tutorial.returnText());
-        menuWindow.draw(menuButton.GetButton());
-        menuWindow.draw(menuButton.GetButtonText());
+        menuWindow.draw(title);
+        menuWindow.draw(author);
+        menuWindow.draw(tutorial);
+        menuWindow.draw(menuButton);
         menuWindow.display();
     }
     return 3;
 }
 
+////////////////BENCHMARK SETTINGS AND FUNCTIONS///////////////////////////////////
+
+#ifdef MAZE_BENCHMARK
+
+/**
+ * @brief Times the solvers on one maze and prints a row of results, each solver answers the same start to end query and a set of random queries
+ *
+ * @param maze
+ * @param loopDensity
+ */
+void BenchmarkSolvers(const PackedMaze &maze, float loopDensity) {
+    const int queries = 20;
+    BFSSolver bfs;
+    AStarSolver aStar;
+    BidirectionalBFSSolver bidirectional;
+    vector<int> path;
+    Clock clock;
+    long long bfsTime = 0, aStarTime = 0, bidirectionalTime = 0, bfsExpanded = 0, aStarExpanded = 0, bidirectionalExpanded = 0;
+    bool lengthsAgree = true;
+
+    mt19937 random(7);
+    for (int i = 0; i < queries; i++) {
+        int start = (i == 0) ? 0 : random() % maze.CellCount();
+        int goal = (i == 0) ? maze.CellCount() - 1 : random() % maze.CellCount();
+
+        clock.restart();
+        bfs.Solve(maze, start, goal, path);
+        bfsTime += clock.getElapsedTime().asMicroseconds();
+        bfsExpanded += bfs.NodesExpanded();
+        size_t bfsLength = path.size();
+
+        clock.restart();
+        aStar.Solve(maze, start, goal, path);
+        aStarTime += clock.getElapsedTime().asMicroseconds();
+        aStarExpanded += aStar.NodesExpanded();
+        size_t aStarLength = path.size();
+
+        clock.restart();
+        bidirectional.Solve(maze, start, goal, path);
+        bidirectionalTime += clock.getElapsedTime().asMicroseconds();
+        bidirectionalExpanded += bidirectional.NodesExpanded();
+
+        // Every solver returns a shortest path, so the three lengths have to be the same
+        lengthsAgree = lengthsAgree && bfsLength == aStarLength && bfsLength == path.size();
+    }
+
+    cout << setw(6) << maze.Width() << "x" << setw(6) << left << maze.Height() << right << " loops " << setprecision(2) << loopDensity
+         << " | BFS " << setw(9) << bfsTime / 1000.0 / queries << " ms " << setw(11) << bfsExpanded / queries << " expanded "
+         << (double)bfs.MemoryUsed() / maze.CellCount() << " B/cell | A* " << setw(9) << aStarTime / 1000.0 / queries << " ms " << setw(11)
+         << aStarExpanded / queries << " expanded | Bidirectional " << setw(9) << bidirectionalTime / 1000.0 / queries << " ms " << setw(11)
+         << bidirectionalExpanded / queries << " expanded | " << (lengthsAgree ? "lengths agree" : "MISMATCH") << setprecision(3) << endl;
+}
+
+/**
+ * @brief Times the parallel breadth first search against the serial one on one maze and checks that every distance matches
+ *
+ * @param maze
+ * @param loopDensity
+ * @param pool
+ */
+void BenchmarkParallelBFS(const PackedMaze &maze, float loopDensity, WorkerPool &pool) {
+    DistanceField serial;
+    ParallelBFS parallel(pool);
+    Clock clock;
+
+    clock.restart();
+    serial.Compute(maze, 0);
+    long long serialTime = clock.getElapsedTime().asMicroseconds();
+
+    clock.restart();
+    parallel.Compute(maze, 0);
+    long long parallelTime = clock.getElapsedTime().asMicroseconds();
+
+    bool identical = true;
+    for (int i = 0; i < maze.CellCount() && identical; i++) {
+        identical = (serial.Distance(i) == parallel.Distance(i));
+    }
+    cout << setw(6) << maze.Width() << "x" << setw(6) << left << maze.Height() << right << " loops " << setprecision(2) << loopDensity
+         << " | serial BFS " << setw(9) << serialTime / 1000.0 << " ms | parallel BFS " << setw(9) << parallelTime / 1000.0 << " ms on "
+         << pool.ThreadCount() << " threads, " << parallel.Levels() << " levels, " << parallel.BottomUpLevels() << " bottom up | "
+         << (identical ? "identical" : "MISMATCH") << setprecision(3) << endl;
+}
+
+/**
+ * @brief Forces the parallel search to expand every level bottom up and checks its distances against the breadth first search solver, the
+ * default ratio rarely switches on a maze so the bottom up steps would otherwise go unchecked
+ *
+ * @param maze
+ * @param loopDensity
+ * @param pool
+ */
+void BenchmarkBottomUpBFS(const PackedMaze &maze, float loopDensity, WorkerPool &pool) {
+    const int queries = 20;
+    ParallelBFS bottomUp(pool, ParallelBFS::ALWAYSBOTTOMUP);
+    BFSSolver bfs;
+    vector<int> path;
+    Clock clock;
+
+    clock.restart();
+    bottomUp.Compute(maze, 0);
+    long long bottomUpTime = clock.getElapsedTime().asMicroseconds();
+
+    // The solver's shortest path to a cell is one longer than the cell's distance, the farthest corner is always one of the cells checked
+    bool identical = bottomUp.BottomUpLevels() == bottomUp.Levels();
+    mt19937 random(7);
+    for (int i = 0; i < queries && identical; i++) {
+        int goal = (i == 0) ? maze.CellCount() - 1 : random() % maze.CellCount();
+        bool found = bfs.Solve(maze, 0, goal, path);
+        identical = found ? bottomUp.Distance(goal) == path.size() - 1 : bottomUp.Distance(goal) == ParallelBFS::UNREACHABLE;
+    }
+    cout << setw(6) << maze.Width() << "x" << setw(6) << left << maze.Height() << right << " loops " << setprecision(2) << loopDensity << setprecision(3)
+         << " | bottom up BFS " << setw(9) << bottomUpTime / 1000.0 << " ms on " << pool.ThreadCount() << " threads, " << bottomUp.BottomUpLevels()
+         << " of " << bottomUp.Levels() << " levels bottom up | " << (identical ? "matches BFS" : "MISMATCH") << endl;
+}
+
+/**
+ * @brief Plain dead end filling one cell at a time, every cell with a single open side goes on a list and filling it can put its neighbour on
+ * the list too. Used as the baseline the word parallel filler is timed and checked against
+ *
+ * @param maze
+ * @param start
+ * @param goal
+ * @param filled
+ */
+void FillDeadEndsPerCell(const PackedMaze &maze, int start, int goal, vector<uint8_t> &filled) {
+    vector<uint8_t> openSides(maze.CellCount());
+    vector<int> deadEnds;
+    filled.assign(maze.CellCount(), 0);
+    for (int i = 0; i < maze.CellCount(); i++) {
+        openSides[i] = __builtin_popcount(maze.OpenMask(i));
+        if (openSides[i] == 1 && i != start && i != goal) {
+            deadEnds.push_back(i);
+        }
+    }
+    while (!deadEnds.empty()) {
+        int cell = deadEnds.back();
+        deadEnds.pop_back();
+        filled[cell] = 1;
+        int open = maze.OpenMask(cell);
+        for (int direction = 0; direction < 4; direction++) {
+            int next = maze.Neighbour(cell, direction);
+            if (((open >> direction) & 1) && !filled[next] && --openSides[next] == 1 && next != start && next != goal) {
+                deadEnds.push_back(next);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Times the word parallel dead end filler on the calling thread and on a pool against filling one cell at a time. The filled cells have
+ * to match the per cell fill, and on a perfect maze the corridor left over has to be exactly the shortest path found by breadth first search
+ *
+ * @param maze
+ * @param loopDensity
+ * @param pool
+ */
+void BenchmarkDeadEndFilling(const PackedMaze &maze, float loopDensity, WorkerPool &pool) {
+    int goal = maze.CellCount() - 1;
+    DeadEndFiller serial;
+    DeadEndFiller parallel(&pool);
+    vector<uint8_t> reference;
+    Clock clock;
+
+    clock.restart();
+    FillDeadEndsPerCell(maze, 0, goal, reference);
+    long long perCellTime = clock.getElapsedTime().asMicroseconds();
+
+    clock.restart();
+    serial.Solve(maze);
+    long long serialTime = clock.getElapsedTime().asMicroseconds();
+
+    clock.restart();
+    parallel.Solve(maze);
+    long long parallelTime = clock.getElapsedTime().asMicroseconds();
+
+    bool identical = true;
+    for (int i = 0; i < maze.CellCount() && identical; i++) {
+        identical = (serial.OnSolution(maze, i) == !reference[i]) && (parallel.OnSolution(maze, i) == !reference[i]);
+    }
+
+    // The padding bits past the end of each row are never filled, so the corridor is every cell minus the set bits of the mask
+    long long corridor = maze.CellCount();
+    const vector<uint64_t> &mask = serial.FilledMask();
+    for (size_t w = 0; w < mask.size(); w++) {
+        corridor -= __builtin_popcountll(mask[w]);
+    }
+    const char *shortest = "";
+    if (loopDensity == 0.0f) {
+        BFSSolver bfs;
+        vector<int> path;
+        bfs.Solve(maze, 0, goal, path);
+        bool onPath = (long long)path.size() == corridor;
+        for (size_t i = 0; i < path.size() && onPath; i++) {
+            onPath = serial.OnSolution(maze, path[i]);
+        }
+        shortest = onPath ? ", corridor is the shortest path" : ", corridor MISMATCH";
+    }
+    cout << setw(6) << maze.Width() << "x" << setw(6) << left << maze.Height() << right << " loops " << setprecision(2) << loopDensity << setprecision(3)
+         << " | per cell fill " << setw(9) << perCellTime / 1000.0 << " ms | word fill " << setw(9) << serialTime / 1000.0 << " ms in "
+         << serial.Passes() << " rounds | on pool " << setw(9) << parallelTime / 1000.0 << " ms on " << pool.ThreadCount() << " threads in "
+         << parallel.Passes() << " rounds | " << corridor << " corridor cells | " << (identical ? "identical" : "MISMATCH") << shortest << endl;
+}
+
+/**
+ * @brief Opens and closes random inner walls one at a time, repairs the distance field after each change and checks it against a fresh search
+ *
+ * @param maze
+ * @param loopDensity
+ * @param changes
+ */
+void BenchmarkWallRepair(PackedMaze maze, float loopDensity, int changes) {
+    DistanceField repaired;
+    DistanceField fresh;
+    repaired.Compute(maze, 0);
+    Clock clock;
+    long long repairTime = 0, computeTime = 0;
+    bool identical = true;
+
+    mt19937 random(7);
+    for (int i = 0; i < changes; i++) {
+        // Only the right and bottom sides are picked so the wall is always shared with a neighbour inside the maze
+        int index = random() % maze.CellCount();
+        int direction = 1 + random() % 2;
+        if ((direction == 1 && index % maze.Width() == maze.Width() - 1) || (direction == 2 && index / maze.Width() == maze.Height() - 1)) {
+            direction = 3 - direction;
+            if ((direction == 1 && index % maze.Width() == maze.Width() - 1) || (direction == 2 && index / maze.Width() == maze.Height() - 1)) {
+                continue;
+            }
+        }
+
+        clock.restart();
+        if (maze.IsOpen(index, direction)) {
+            maze.AddWall(index, direction);
+            repaired.WallAdded(maze, index, direction);
+        } else {
+            maze.RemoveWall(index, direction);
+            repaired.WallRemoved(maze, index, direction);
+        }
+        repairTime += clock.getElapsedTime().asMicroseconds();
+
+        clock.restart();
+        fresh.Compute(maze, 0);
+        computeTime += clock.getElapsedTime().asMicroseconds();
+
+        for (int cell = 0; cell < maze.CellCount() && identical; cell++) {
+            identical = (repaired.Distance(cell) == fresh.Distance(cell));
+        }
+    }
+    cout << setw(6) << maze.Width() << "x" << setw(6) << left << maze.Height() << right << " loops " << setprecision(2) << loopDensity << setprecision(3)
+         << " | " << changes << " wall changes | repair " << setw(9) << repairTime / 1000.0 / changes << " ms | recompute " << setw(9)
+         << computeTime / 1000.0 / changes << " ms | " << (identical ? "identical" : "MISMATCH") << endl;
+}
+
+/**
+ * @brief Checks the tree distance index against breadth first searches on a perfect maze and times its queries. Each search from a target
+ * gives the true distance of every cell to it, the index has to return the same distance and a next step one closer for random cells
+ *
+ * @param maze
+ * @param queries
+ */
+void BenchmarkTreeDistance(const PackedMaze &maze, int queries) {
+    const int targets = 8;
+    TreeDistanceIndex tree;
+    DistanceField field;
+    Clock clock;
+
+    clock.restart();
+    tree.Build(maze, 0);
+    long long buildTime = clock.getElapsedTime().asMicroseconds();
+
+    mt19937 random(7);
+    bool identical = true;
+    for (int t = 0; t < targets; t++) {
+        int target = random() % maze.CellCount();
+        field.Compute(maze, target);
+        for (int q = 0; q < queries / targets; q++) {
+            int cell = random() % maze.CellCount();
+            int next = tree.NextStep(maze, cell, target);
+            uint32_t expected = (cell == target) ? 0 : field.Distance(cell) - 1;
+            identical = identical && tree.Distance(cell, target) == field.Distance(cell) && field.Distance(next) == expected;
+        }
+    }
+
+    vector<int> cells(2 * queries);
+    for (size_t i = 0; i < cells.size(); i++) {
+        cells[i] = random() % maze.CellCount();
+    }
+    uint64_t checksum = 0;
+    clock.restart();
+    for (int q = 0; q < queries; q++) {
+        checksum += tree.Distance(cells[2 * q], cells[2 * q + 1]);
+    }
+    long long distanceTime = max<long long>(1, clock.getElapsedTime().asMicroseconds());
+    clock.restart();
+    for (int q = 0; q < queries; q++) {
+        checksum += tree.NextStep(maze, cells[2 * q], cells[2 * q + 1]);
+    }
+    long long stepTime = max<long long>(1, clock.getElapsedTime().asMicroseconds());
+
+    cout << setw(6) << maze.Width() << "x" << setw(6) << left << maze.Height() << right << " tree index | build " << setw(9) << buildTime / 1000.0
+         << " ms | " << setw(7) << queries / (double)distanceTime << " M distances/s | " << setw(7) << queries / (double)stepTime
+         << " M next steps/s | checksum " << checksum % 1000 << " | " << (identical ? "matches BFS" : "MISMATCH") << endl;
+}
+
+/**
+ * @brief Times enemy ticks where every enemy is due to move, which is the worst case a frame can hit
+ *
+ * @param maze
+ * @param enemyCount
+ */
+void BenchmarkEnemies(const PackedMaze &maze, int enemyCount) {
+    const int ticks = 20;
+    const int movePeriod = 2000;
+    const int frames = 600;
+    const int frameTime = 16667;
+    EntityWorld wandererWorld;
+    EntityWorld hunterWorld;
+    EntityWorld variedWorld;
+    EnemySystem wanderers(wandererWorld, 7);
+    EnemySystem hunters(hunterWorld, 7);
+    EnemySystem varied(variedWorld, 7);
+    mt19937 random(7);
+    for (int i = 0; i < enemyCount; i++) {
+        int cell = random() % maze.CellCount();
+        wanderers.Spawn(cell, EnemySystem::WANDERER, movePeriod, movePeriod);
+        hunters.Spawn(cell, EnemySystem::HUNTER, movePeriod, movePeriod);
+        varied.Spawn(cell, EnemySystem::WANDERER, 500 + random() % 4500, 500 + random() % 4500);
+    }
+    wanderers.BuildDistances(maze);
+    hunters.BuildDistances(maze);
+    varied.BuildDistances(maze);
+    Clock clock;
+
+    clock.restart();
+    for (int tick = 0; tick < ticks; tick++) {
+        wanderers.Update(maze, movePeriod * 1000, 0);
+    }
+    long long wandererTime = clock.getElapsedTime().asMicroseconds();
+
+    // The player steps every tick so the hunters' flow field is searched again each time
+    clock.restart();
+    for (int tick = 0; tick < ticks; tick++) {
+        hunters.Update(maze, movePeriod * 1000, tick);
+    }
+    long long hunterTime = clock.getElapsedTime().asMicroseconds();
+
+    // Enemies on their own cadences, at 60 frames a second only the ones that are due get touched
+    clock.restart();
+    for (int frame = 0; frame < frames; frame++) {
+        varied.Update(maze, frameTime, 0);
+    }
+    long long variedTime = clock.getElapsedTime().asMicroseconds();
+
+    cout << setw(6) << maze.Width() << "x" << setw(6) << left << maze.Height() << right << " " << setw(7) << enemyCount << " enemies | wanderer tick "
+         << setw(9) << wandererTime / 1000.0 / ticks << " ms | hunter tick " << setw(9) << hunterTime / 1000.0 / ticks
+         << " ms | varied cadence frame " << setw(9) << variedTime / 1000.0 / frames << " ms" << endl;
+}
+
+/**
+ * @brief Times enemy ticks with the moves picked on the calling thread against the same ticks picked on the pool, and checks both end with
+ * every enemy in the same cell
+ *
+ * @param maze
+ * @param enemyCount
+ * @param pool
+ */
+void BenchmarkParallelEnemies(const PackedMaze &maze, int enemyCount, WorkerPool &pool) {
+    const int ticks = 20;
+    const int movePeriod = 2000;
+    EntityWorld serialWorld;
+    EntityWorld parallelWorld;
+    EnemySystem serial(serialWorld, 7);
+    EnemySystem parallel(parallelWorld, 7, &pool);
+    mt19937 random(7);
+    for (int i = 0; i < enemyCount; i++) {
+        int cell = random() % maze.CellCount();
+        int type = (i % 4 == 0) ? EnemySystem::HUNTER : EnemySystem::WANDERER;
+        serial.Spawn(cell, type, movePeriod, movePeriod);
+        parallel.Spawn(cell, type, movePeriod, movePeriod);
+    }
+    serial.BuildDistances(maze);
+    parallel.BuildDistances(maze);
+    Clock clock;
+
+    clock.restart();
+    for (int tick = 0; tick < ticks; tick++) {
+        serial.Update(maze, movePeriod * 1000, tick);
+    }
+    long long serialTime = clock.getElapsedTime().asMicroseconds();
+
+    clock.restart();
+    for (int tick = 0; tick < ticks; tick++) {
+        parallel.Update(maze, movePeriod * 1000, tick);
+    }
+    long long parallelTime = clock.getElapsedTime().asMicroseconds();
+
+    bool identical = true;
+    for (int i = 0; i < enemyCount && identical; i++) {
+        identical = (serialWorld.GetCellID(i) == parallelWorld.GetCellID(i)) && (serialWorld.IsAttacking(i) == parallelWorld.IsAttacking(i));
+    }
+    cout << setw(6) << maze.Width() << "x" << setw(6) << left << maze.Height() << right << " " << setw(7) << enemyCount << " enemies | serial tick "
+         << setw(9) << serialTime / 1000.0 / ticks << " ms | parallel tick " << setw(9) << parallelTime / 1000.0 / ticks << " ms on "
+         << pool.ThreadCount() << " threads | " << (identical ? "identical" : "MISMATCH") << endl;
+}
+
+/**
+ * @brief Times frames at 60 frames a second with every enemy at full speed against the same frames with the AI level of detail slowing
+ * down the enemies far from the player
+ *
+ * @param maze
+ * @param enemyCount
+ * @param detailDistance
+ */
+void BenchmarkLevelOfDetail(const PackedMaze &maze, int enemyCount, uint32_t detailDistance) {
+    const int frames = 600;
+    const int frameTime = 16667;
+    const int slowdown = 8;
+    EntityWorld fullWorld;
+    EntityWorld detailWorld;
+    EnemySystem full(fullWorld, 7);
+    EnemySystem detail(detailWorld, 7);
+    detail.SetLevelOfDetail(detailDistance, slowdown);
+    mt19937 random(7);
+    for (int i = 0; i < enemyCount; i++) {
+        int cell = random() % maze.CellCount();
+        int period = 500 + random() % 1500;
+        full.Spawn(cell, EnemySystem::WANDERER, period, period);
+        detail.Spawn(cell, EnemySystem::WANDERER, period, period);
+    }
+    full.BuildDistances(maze);
+    detail.BuildDistances(maze);
+    int playerCell = maze.CellCount() / 2 + maze.Width() / 2;
+    Clock clock;
+
+    long long fullMoves = 0;
+    clock.restart();
+    for (int frame = 0; frame < frames; frame++) {
+        full.Update(maze, frameTime, playerCell);
+        fullMoves += full.MovesLastUpdate();
+    }
+    long long fullTime = clock.getElapsedTime().asMicroseconds();
+
+    long long detailMoves = 0;
+    clock.restart();
+    for (int frame = 0; frame < frames; frame++) {
+        detail.Update(maze, frameTime, playerCell);
+        detailMoves += detail.MovesLastUpdate();
+    }
+    long long detailTime = clock.getElapsedTime().asMicroseconds();
+
+    cout << setw(6) << maze.Width() << "x" << setw(6) << left << maze.Height() << right << " " << setw(7) << enemyCount
+         << " enemies | full detail frame " << setw(9) << fullTime / 1000.0 / frames << " ms " << setw(8) << fullMoves / frames
+         << " moves | detail past " << detailDistance << " steps frame " << setw(9) << detailTime / 1000.0 / frames << " ms " << setw(8)
+         << detailMoves / frames << " moves" << endl;
+}
+
+/**
+ * @brief Checks that slowed enemies catch up when the player comes close. A lone wanderer spawned far from the player makes its first move,
+ * which schedules the next one at the slowed period, then the player steps next to it and it has to move again within one normal period
+ *
+ * @param maze
+ * @param trials
+ * @param detailDistance
+ */
+void BenchmarkDetailCatchUp(const PackedMaze &maze, int trials, uint32_t detailDistance) {
+    const int frameTime = 16667;
+    const int period = 1000;
+    const int slowdown = 8;
+    int playerStart = maze.CellCount() / 2 + maze.Width() / 2;
+    DistanceField fromPlayer;
+    fromPlayer.Compute(maze, playerStart);
+    mt19937 random(7);
+    long long worstLag = 0;
+    bool caughtUp = true;
+
+    for (int trial = 0; trial < trials; trial++) {
+        int cell = random() % maze.CellCount();
+        while (fromPlayer.Distance(cell) <= detailDistance || cell == 0 || cell == maze.CellCount() - 1) {
+            cell = random() % maze.CellCount();
+        }
+        EntityWorld world;
+        EnemySystem enemies(world, trial);
+        enemies.SetLevelOfDetail(detailDistance, slowdown);
+        int enemy = enemies.Spawn(cell, EnemySystem::WANDERER, period, period);
+        enemies.BuildDistances(maze);
+        do {
+            enemies.Update(maze, frameTime, playerStart);
+        } while (enemies.MovesLastUpdate() == 0);
+
+        int open = maze.OpenMask(world.GetCellID(enemy));
+        int direction = 0;
+        while (!((open >> direction) & 1)) {
+            direction++;
+        }
+        int playerCell = maze.Neighbour(world.GetCellID(enemy), direction);
+        long long lag = 0;
+        bool moved = false;
+        while (!moved && lag <= (long long)period * 1000 + frameTime) {
+            enemies.Update(maze, frameTime, playerCell);
+            lag += frameTime;
+            moved = enemies.MovesLastUpdate() > 0;
+        }
+        caughtUp = caughtUp && moved;
+        worstLag = max(worstLag, lag);
+    }
+    cout << setw(6) << maze.Width() << "x" << setw(6) << left << maze.Height() << right << " " << setw(7) << trials << " slowed enemies | player steps"
+         << " next to them | worst wait " << setw(9) << worstLag / 1000.0 << " ms for a " << period << " ms period | "
+         << (caughtUp ? "caught up" : "LATE") << endl;
+}
+
+/**
+ * @brief Times placing spawns at least a given distance from the corner of a maze and checks every cell handed out is different and meets
+ * the constraint
+ *
+ * @param maze
+ * @param spawnCount
+ * @param minDistance
+ */
+void BenchmarkSpawns(const PackedMaze &maze, int spawnCount, uint32_t minDistance) {
+    DistanceField field;
+    field.Compute(maze, 0);
+    SpawnSampler sampler(7);
+    Clock clock;
+
+    clock.restart();
+    sampler.Build(field, maze.CellCount(), minDistance);
+    long long buildTime = clock.getElapsedTime().asMicroseconds();
+
+    vector<int> cells;
+    clock.restart();
+    for (int i = 0; i < spawnCount && sampler.Remaining() > 0; i++) {
+        cells.push_back(sampler.Take());
+    }
+    long long takeTime = clock.getElapsedTime().asMicroseconds();
+
+    vector<uint8_t> used(maze.CellCount(), 0);
+    bool valid = true;
+    for (size_t i = 0; i < cells.size() && valid; i++) {
+        valid = !used[cells[i]] && field.Distance(cells[i]) >= minDistance;
+        used[cells[i]] = 1;
+    }
+    cout << setw(6) << maze.Width() << "x" << setw(6) << left << maze.Height() << right << " " << setw(7) << cells.size() << " spawns at least "
+         << minDistance << " steps out | build " << setw(9) << buildTime / 1000.0 << " ms | take " << setw(9) << takeTime / 1000.0 << " ms | "
+         << (valid ? "valid" : "INVALID") << endl;
+}
+
+/**
+ * @brief Times frames of the maze drawn five ways into a window sized off screen target: five shapes per cell like the grid draws, the
+ * batched mesh with and without culling to the view, the cached background sprite and the atlas tiles
+ *
+ * @param maze
+ * @param frames
+ */
+void BenchmarkMazeDrawing(const PackedMaze &maze, int frames) {
+    RenderTexture target;
+    if (!target.create(WINDOWDIMENSIONS, WINDOWDIMENSIONS)) {
+        cout << setw(6) << maze.Width() << "x" << setw(6) << left << maze.Height() << right << " maze drawing skipped, no render texture" << endl;
+        return;
+    }
+    const float size = CELLSIZE - 3;
+    const Vector2f wallOffsets[4] = {Vector2f(0, -2), Vector2f(size, 0), Vector2f(0, size + 2), Vector2f(-4, 0)};
+    RectangleShape cell(Vector2f(size, size));
+    RectangleShape horizontalWall(Vector2f(size, 2));
+    RectangleShape verticalWall(Vector2f(2, size));
+    MazeMesh mesh;
+    mesh.Build(maze);
+    MazeBackground background;
+    background.Build(maze);
+    TileAtlas atlas;
+    bool tiled = atlas.Build();
+    TileMap tiles;
+    tiles.Build(maze, atlas);
+    Clock clock;
+
+    clock.restart();
+    for (int frame = 0; frame < frames; frame++) {
+        target.clear();
+        for (int i = 0; i < maze.CellCount(); i++) {
+            float x = (i % maze.Width()) * CELLSIZE;
+            float y = (i / maze.Width()) * CELLSIZE;
+            int open = maze.OpenMask(i);
+            cell.setPosition(x, y);
+            cell.setFillColor(i == 0 ? Color::Red : (i == maze.CellCount() - 1 ? Color::Green : Color::Black));
+            target.draw(cell);
+            for (int j = 0; j < 4; j++) {
+                RectangleShape &wall = (j & 1) ? verticalWall : horizontalWall;
+                wall.setPosition(x + wallOffsets[j].x, y + wallOffsets[j].y);
+                wall.setFillColor(((open >> j) & 1) ? Color::Black : Color::Blue);
+                target.draw(wall);
+            }
+        }
+        target.display();
+    }
+    long long cellTime = clock.getElapsedTime().asMicroseconds();
+
+    clock.restart();
+    for (int frame = 0; frame < frames; frame++) {
+        target.clear();
+        target.draw(mesh);
+        target.display();
+    }
+    long long meshTime = clock.getElapsedTime().asMicroseconds();
+
+    clock.restart();
+    for (int frame = 0; frame < frames; frame++) {
+        target.clear();
+        mesh.DrawAll(target);
+        target.display();
+    }
+    long long unculledTime = clock.getElapsedTime().asMicroseconds();
+
+    clock.restart();
+    for (int frame = 0; frame < frames; frame++) {
+        target.clear();
+        target.draw(background);
+        target.display();
+    }
+    long long backgroundTime = clock.getElapsedTime().asMicroseconds();
+
+    clock.restart();
+    for (int frame = 0; frame < frames; frame++) {
+        target.clear();
+        target.draw(tiles);
+        target.display();
+    }
+    long long tileTime = clock.getElapsedTime().asMicroseconds();
+
+    cout << setw(6) << maze.Width() << "x" << setw(6) << left << maze.Height() << right << " maze frame | per cell " << setw(9) << cellTime / 1000.0 / frames
+         << " ms | mesh " << setw(9) << meshTime / 1000.0 / frames << " ms culled, " << setw(9) << unculledTime / 1000.0 / frames << " ms unculled ("
+         << (mesh.IsUploaded() ? "vertex buffer" : "vertex array") << ") | background " << setw(9) << backgroundTime / 1000.0 / frames << " ms (" << (background.IsCached() ? "sprite" : "too large, mesh")
+         << ") | tiles " << setw(9) << tileTime / 1000.0 / frames << " ms" << (tiled ? "" : " (no atlas)") << endl;
+}
+
+/**
+ * @brief Times frames of a world full of entities drawn into a window sized off screen target, once as the batch of flat coloured bodies and
+ * once as atlas tiles, and reports the draw calls each frame took
+ *
+ * @param entityCount
+ * @param frames
+ */
+void BenchmarkEntityDrawing(int entityCount, int frames) {
+    RenderTexture target;
+    if (!target.create(WINDOWDIMENSIONS, WINDOWDIMENSIONS)) {
+        cout << setw(7) << entityCount << " entities drawing skipped, no render texture" << endl;
+        return;
+    }
+    EntityWorld world;
+    mt19937 random(entityCount);
+    for (int i = 0; i < entityCount; i++) {
+        int entity = world.Create(random() % (CELLCOUNT * CELLCOUNT), EntityWorld::ENEMYTEAM, (i % 2) ? 3 : 4);
+        if (i % 3 == 0) {
+            world.SwitchState(entity);
+        }
+    }
+    world.UpdateTransforms(IntRect(0, 0, CELLCOUNT, CELLCOUNT));
+    TileAtlas atlas;
+    bool tiled = atlas.Build();
+    EntityTiles tiles(world, atlas);
+    Clock clock;
+
+    clock.restart();
+    for (int frame = 0; frame < frames; frame++) {
+        target.clear();
+        target.draw(world);
+        target.display();
+    }
+    long long batchTime = clock.getElapsedTime().asMicroseconds();
+
+    clock.restart();
+    for (int frame = 0; frame < frames; frame++) {
+        target.clear();
+        target.draw(tiles);
+        target.display();
+    }
+    long long tileTime = clock.getElapsedTime().asMicroseconds();
+
+    cout << setw(7) << entityCount << " entities frame | bodies " << setw(9) << batchTime / 1000.0 / frames << " ms in " << world.DrawCalls()
+         << " draw calls | tiles " << setw(9) << tileTime / 1000.0 / frames << " ms in " << tiles.DrawCalls() << " draw calls"
+         << (tiled ? "" : " (no atlas)") << endl;
+}
+
+/**
+ * @brief Runs every benchmark over a range of maze sizes and loop densities, build with -DMAZE_BENCHMARK to run these instead of the game
+ *
+ * @return int
+ */
+int RunBenchmarks() {
+    cout << fixed << setprecision(3);
+    const int sizes[] = {256, 1024, 4096};
+    const float loopDensities[] = {0.0f, 0.05f, 0.25f};
+
+    for (int size : sizes) {
+        for (float loopDensity : loopDensities) {
+            PackedMaze maze(size, size);
+            maze.GenerateMaze(size);
+            maze.AddLoops(loopDensity, size);
+            BenchmarkSolvers(maze, loopDensity);
+        }
+    }
+
+    WorkerPool pool;
+    for (int size : sizes) {
+        for (float loopDensity : loopDensities) {
+            PackedMaze maze(size, size);
+            maze.GenerateMaze(size);
+            maze.AddLoops(loopDensity, size);
+            BenchmarkParallelBFS(maze, loopDensity, pool);
+        }
+    }
+
+    // Every bottom up level scans the whole maze and a perfect maze has thousands of levels, so this stays on small sizes
+    for (int size : {64, 128}) {
+        for (float loopDensity : loopDensities) {
+            PackedMaze maze(size, size);
+            maze.GenerateMaze(size);
+            maze.AddLoops(loopDensity, size);
+            BenchmarkBottomUpBFS(maze, loopDensity, pool);
+        }
+    }
+
+    for (int size : sizes) {
+        for (float loopDensity : loopDensities) {
+            PackedMaze maze(size, size);
+            maze.GenerateMaze(size);
+            maze.AddLoops(loopDensity, size);
+            BenchmarkDeadEndFilling(maze, loopDensity, pool);
+        }
+    }
+
+    for (int size : {256, 1024}) {
+        for (float loopDensity : loopDensities) {
+            PackedMaze maze(size, size);
+            maze.GenerateMaze(size);
+            maze.AddLoops(loopDensity, size);
+            BenchmarkWallRepair(maze, loopDensity, 200);
+        }
+    }
+
+    for (int size : {256, 1024}) {
+        PackedMaze maze(size, size);
+        maze.GenerateMaze(size);
+        BenchmarkTreeDistance(maze, 1000000);
+    }
+
+    const int enemyCounts[] = {1000, 10000, 100000};
+    for (int size : {256, 1024}) {
+        PackedMaze maze(size, size);
+        maze.GenerateMaze(size);
+        for (int enemyCount : enemyCounts) {
+            BenchmarkEnemies(maze, enemyCount);
+            BenchmarkParallelEnemies(maze, enemyCount, pool);
+        }
+        BenchmarkLevelOfDetail(maze, 100000, 64);
+        BenchmarkDetailCatchUp(maze, 100, 64);
+        BenchmarkSpawns(maze, 100000, size / 4);
+    }
+
+    for (int size : {16, 128, 512}) {
+        PackedMaze maze(size, size);
+        maze.GenerateMaze(size);
+        BenchmarkMazeDrawing(maze, 30);
+    }
+
+    for (int entityCount : {100, 10000}) {
+        BenchmarkEntityDrawing(entityCount, 30);
+    }
+    return 0;
+}
+
+#endif
+
+////////////////BENCHMARK SETTINGS AND FUNCTIONS///////////////////////////////////
+
 /**
  * @brief Checks which screen to render and renders it
  *
  * @return int
  */
 int main() {
+#ifdef MAZE_BENCHMARK
+    return RunBenchmarks();
+#endif
     int i = RenderUIWindow();
     while (i != 3) {
         switch (i) {